@@ -0,0 +1,172 @@
+#ifndef LAYOUTS_H
+#define LAYOUTS_H
+
+#include <stddef.h>
+#include <immintrin.h>
+#include "matrix.h"
+#include "simd_kernels.h"
+
+// Side (in elements) of the tiles of the blocked layouts: one 8x8 block of the AVX2 kernels, stored as 64
+// contiguous floats (4 cache lines), rows of the tile one after the other.
+//  * tiled: the tiles follow each other in row-major order of the grid of tiles
+//  * morton: the tiles follow the Z-order curve, the bits of the tile row and column interleaved, so every
+//    aligned square of 2^k x 2^k tiles is contiguous at every level and both the rows and the columns of the
+//    matrix are read from nearby memory
+// The matrix is transposed in both layouts without going back to row-major: every tile is transposed in
+// registers and written at the place of the mirrored tile, which is only a permutation of the tile indices
+#define LAYOUT_TILE 8
+#define LAYOUT_TILE_ELEMENTS (LAYOUT_TILE * LAYOUT_TILE)
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% TILE INDICES %%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns 1 if a rows x cols matrix can be stored in the tiled layout (both sides multiple of the tile)
+static inline int tiledLayoutSupported(int rows, int cols) {
+    return rows > 0 && cols > 0 && rows % LAYOUT_TILE == 0 && cols % LAYOUT_TILE == 0;
+}
+
+//returns 1 if a rows x cols matrix can be stored in the Morton layout (square, power of two side of at least one tile)
+static inline int mortonLayoutSupported(int rows, int cols) {
+    return rows == cols && rows >= LAYOUT_TILE && (rows & (rows - 1)) == 0;
+}
+
+//offset (in floats) of the tile (ti, tj) in the tiled layout, with tiles_per_row tiles in every row of the grid
+static inline size_t tiledOffset(int ti, int tj, int tiles_per_row) {
+    return ((size_t)ti * tiles_per_row + tj) * LAYOUT_TILE_ELEMENTS;
+}
+
+//spreads the lower 16 bits of x on the even bits of the result
+static inline unsigned mortonSpread(unsigned x) {
+    x &= 0xFFFF;
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    x = (x | (x << 1)) & 0x55555555;
+    return x;
+}
+
+//offset (in floats) of the tile (ti, tj) in the Morton layout: the column on the even bits, the row on the odd ones
+static inline size_t mortonOffset(int ti, int tj) {
+    return (size_t)(mortonSpread((unsigned)tj) | (mortonSpread((unsigned)ti) << 1)) * LAYOUT_TILE_ELEMENTS;
+}
+
+//Morton index of the tile mirrored across the diagonal: the tile row and column bits swapped
+static inline unsigned mortonTransposedIndex(unsigned z) {
+    return ((z & 0x55555555) << 1) | ((z >> 1) & 0x55555555);
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//copies the 8x8 block at src (rows lds floats apart) into dst (rows ldd floats apart), a row per register
+static inline SIMD_TARGET_AVX2 void copyBlock8x8(const float *src, int lds, float *dst, int ldd) {
+    for (int k = 0; k < 8; k++) {
+        _mm256_storeu_ps(dst + (size_t)k * ldd, _mm256_loadu_ps(src + (size_t)k * lds));
+    }
+}
+
+//stores the row-major matrix in the tiled layout, or its transpose if transposed is not 0 (every tile is
+//then transposed on the way by the 8x8 kernel, so the conversion costs no extra pass). Returns 0 if the
+//sides are not multiples of the tile
+static inline SIMD_TARGET_AVX2 int rowMajorToTiled(const Matrix *matrix, float *tiled, int transposed) {
+    if (!tiledLayoutSupported(matrix->rows, matrix->cols)) {
+        return 0;
+    }
+    int tile_rows = matrix->rows / LAYOUT_TILE;
+    int tile_cols = matrix->cols / LAYOUT_TILE;
+
+    for (int ti = 0; ti < tile_rows; ti++) {
+        for (int tj = 0; tj < tile_cols; tj++) {
+            const float *src = &MAT(matrix, ti * LAYOUT_TILE, tj * LAYOUT_TILE);
+            if (transposed) {
+                transposeBlock8x8(src, matrix->ld, tiled + tiledOffset(tj, ti, tile_rows), LAYOUT_TILE);
+            } else {
+                copyBlock8x8(src, matrix->ld, tiled + tiledOffset(ti, tj, tile_cols), LAYOUT_TILE);
+            }
+        }
+    }
+    return 1;
+}
+
+//stores the tiled layout back into the row-major matrix (of the size of the tiled one). Returns 0 if the
+//sides are not multiples of the tile
+static inline SIMD_TARGET_AVX2 int tiledToRowMajor(const float *tiled, Matrix *matrix) {
+    if (!tiledLayoutSupported(matrix->rows, matrix->cols)) {
+        return 0;
+    }
+    int tile_cols = matrix->cols / LAYOUT_TILE;
+
+    for (int ti = 0; ti < matrix->rows / LAYOUT_TILE; ti++) {
+        for (int tj = 0; tj < tile_cols; tj++) {
+            copyBlock8x8(tiled + tiledOffset(ti, tj, tile_cols), LAYOUT_TILE, &MAT(matrix, ti * LAYOUT_TILE, tj * LAYOUT_TILE), matrix->ld);
+        }
+    }
+    return 1;
+}
+
+//stores the row-major matrix in the Morton layout, or its transpose if transposed is not 0. Returns 0 if
+//the matrix is not square with a power of two side
+static inline SIMD_TARGET_AVX2 int rowMajorToMorton(const Matrix *matrix, float *morton, int transposed) {
+    if (!mortonLayoutSupported(matrix->rows, matrix->cols)) {
+        return 0;
+    }
+    int tiles = matrix->rows / LAYOUT_TILE;
+
+    for (int ti = 0; ti < tiles; ti++) {
+        for (int tj = 0; tj < tiles; tj++) {
+            const float *src = &MAT(matrix, ti * LAYOUT_TILE, tj * LAYOUT_TILE);
+            if (transposed) {
+                transposeBlock8x8(src, matrix->ld, morton + mortonOffset(tj, ti), LAYOUT_TILE);
+            } else {
+                copyBlock8x8(src, matrix->ld, morton + mortonOffset(ti, tj), LAYOUT_TILE);
+            }
+        }
+    }
+    return 1;
+}
+
+//stores the Morton layout back into the row-major matrix. Returns 0 if the matrix is not square with a
+//power of two side
+static inline SIMD_TARGET_AVX2 int mortonToRowMajor(const float *morton, Matrix *matrix) {
+    if (!mortonLayoutSupported(matrix->rows, matrix->cols)) {
+        return 0;
+    }
+    int tiles = matrix->rows / LAYOUT_TILE;
+
+    for (int ti = 0; ti < tiles; ti++) {
+        for (int tj = 0; tj < tiles; tj++) {
+            copyBlock8x8(morton + mortonOffset(ti, tj), LAYOUT_TILE, &MAT(matrix, ti * LAYOUT_TILE, tj * LAYOUT_TILE), matrix->ld);
+        }
+    }
+    return 1;
+}
+
+//transposes the rows x cols matrix stored in the tiled layout into its cols x rows transpose, also tiled:
+//the tile (ti, tj) is transposed in registers into the tile (tj, ti). The sides must be multiples of the tile
+static inline SIMD_TARGET_AVX2 void transposeTiled(const float *tiled, float *transpose, int rows, int cols) {
+    int tile_rows = rows / LAYOUT_TILE;
+    int tile_cols = cols / LAYOUT_TILE;
+
+    for (int ti = 0; ti < tile_rows; ti++) {
+        for (int tj = 0; tj < tile_cols; tj++) {
+            transposeBlock8x8(tiled + tiledOffset(ti, tj, tile_cols), LAYOUT_TILE, transpose + tiledOffset(tj, ti, tile_rows), LAYOUT_TILE);
+        }
+    }
+}
+
+//transposes the side x side matrix stored in the Morton layout into its transpose, also in the Morton
+//layout: the tiles are read in storage order and each is written at the index with its row and column bits
+//swapped. side must be a power of two of at least one tile
+static inline SIMD_TARGET_AVX2 void transposeMorton(const float *morton, float *transpose, int side) {
+    unsigned tiles = (unsigned)(side / LAYOUT_TILE) * (unsigned)(side / LAYOUT_TILE);
+
+    for (unsigned z = 0; z < tiles; z++) {
+        transposeBlock8x8(morton + (size_t)z * LAYOUT_TILE_ELEMENTS, LAYOUT_TILE, transpose + (size_t)mortonTransposedIndex(z) * LAYOUT_TILE_ELEMENTS, LAYOUT_TILE);
+    }
+}
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <stdlib.h>
+#include <limits.h>
+#include <string.h>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%%% MATRIX TYPE %%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// Alignment (in bytes) of every matrix buffer: one cache line, enough for aligned AVX and AVX-512 accesses
+#define MATRIX_ALIGNMENT 64
+
+// Size of the huge pages requested by allocMatrixHugePages (2MB on x86-64)
+#define HUGE_PAGE_SIZE ((size_t)2 << 20)
+
+// Kind of pages behind a matrix buffer, so that freeMatrix knows how to release it
+#define MATRIX_PAGES_DEFAULT 0      // plain 4KB pages from the aligned allocator
+#define MATRIX_PAGES_TRANSPARENT 1  // 2MB aligned block the kernel was asked to back with transparent huge pages
+#define MATRIX_PAGES_HUGETLB 2      // explicit 2MB pages mapped from the hugetlbfs pool
+
+// Matrix stored in row-major order inside ONE contiguous buffer.
+// Element (i, j) is data[i * ld + j], where ld (leading dimension) is the distance in floats between two rows.
+typedef struct {
+    float *data;
+    int rows;
+    int cols;
+    int ld;
+    int pages;
+} Matrix;
+
+// Padding (in floats) added to every row by "-pad auto": 64 bytes, so that the rows of a power of two
+// matrix no longer start at addresses that map to the same cache sets
+#define MATRIX_AUTO_PADDING 16
+
+// Element (i, j) of the matrix pointed by m
+#define MAT(m, i, j) ((m)->data[(size_t)(i) * (m)->ld + (j)])
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//allocates bytes bytes aligned to MATRIX_ALIGNMENT, for buffers of any element type (returns NULL if the allocation fails)
+static inline void *allocAligned(size_t bytes) {
+    void *buffer;
+
+    #ifdef _WIN32
+        buffer = _aligned_malloc(bytes, MATRIX_ALIGNMENT);
+    #else
+        if (posix_memalign(&buffer, MATRIX_ALIGNMENT, bytes) != 0) {
+            buffer = NULL;
+        }
+    #endif
+
+    return buffer;
+}
+
+//frees a buffer returned by allocAligned
+static inline void freeAligned(void *buffer) {
+    #ifdef _WIN32
+        _aligned_free(buffer);
+    #else
+        free(buffer);
+    #endif
+}
+
+//allocates a rows x cols matrix in a single aligned block whose rows are ld >= cols floats apart
+//(returns 0 if the allocation fails)
+static inline int allocMatrixPadded(Matrix *matrix, int rows, int cols, int ld) {
+    matrix->rows = rows;
+    matrix->cols = cols;
+    matrix->ld = ld;
+    matrix->pages = MATRIX_PAGES_DEFAULT;
+    matrix->data = (float *)allocAligned((size_t)rows * ld * sizeof(float));
+
+    return matrix->data != NULL;
+}
+
+//allocates a rows x cols matrix in a single aligned block with no padding (returns 0 if the allocation fails)
+static inline int allocMatrix(Matrix *matrix, int rows, int cols) {
+    return allocMatrixPadded(matrix, rows, cols, cols);
+}
+
+//same as allocMatrixPadded, backing the buffer with 2MB pages when the system allows it: first explicit
+//huge pages (mmap with MAP_HUGETLB, which needs pages reserved in /proc/sys/vm/nr_hugepages), then
+//transparent huge pages (madvise with MADV_HUGEPAGE), and as a last resort the usual 4KB pages.
+//matrix->pages tells which one was obtained (returns 0 if even the last allocation fails)
+static inline int allocMatrixHugePages(Matrix *matrix, int rows, int cols, int ld) {
+    #if defined(MAP_HUGETLB) && defined(MADV_HUGEPAGE)
+        size_t bytes = (size_t)rows * ld * sizeof(float);
+        size_t rounded = (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+
+        matrix->rows = rows;
+        matrix->cols = cols;
+        matrix->ld = ld;
+
+        void *buffer = mmap(NULL, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (buffer != MAP_FAILED) {
+            matrix->data = (float *)buffer;
+            matrix->pages = MATRIX_PAGES_HUGETLB;
+            return 1;
+        }
+
+        if (posix_memalign(&buffer, HUGE_PAGE_SIZE, rounded) == 0) {
+            // without THP support the advice is refused, but the buffer is still usable with 4KB pages
+            matrix->data = (float *)buffer;
+            matrix->pages = (madvise(buffer, rounded, MADV_HUGEPAGE) == 0) ? MATRIX_PAGES_TRANSPARENT : MATRIX_PAGES_DEFAULT;
+            return 1;
+        }
+    #endif
+
+    return allocMatrixPadded(matrix, rows, cols, ld);
+}
+
+//frees the buffer of the matrix
+static inline void freeMatrix(Matrix *matrix) {
+    #ifndef _WIN32
+        if (matrix->pages == MATRIX_PAGES_HUGETLB) {
+            size_t bytes = (size_t)matrix->rows * matrix->ld * sizeof(float);
+            munmap(matrix->data, (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+            matrix->data = NULL;
+            return;
+        }
+    #endif
+    freeAligned(matrix->data);
+    matrix->data = NULL;
+}
+
+//returns a short description of the pages behind the matrix buffer
+static inline const char *matrixPagesName(const Matrix *matrix) {
+    switch (matrix->pages) {
+        case MATRIX_PAGES_HUGETLB: return "2MB hugetlbfs pages";
+        case MATRIX_PAGES_TRANSPARENT: return "2MB transparent huge pages";
+        default: return "4KB pages";
+    }
+}
+
+//returns a pointer to the first element of row i
+static inline float *matrixRow(const Matrix *matrix, int i) {
+    return matrix->data + (size_t)i * matrix->ld;
+}
+
+//reads the size of the matrix from a command line argument: either an exponent between 4 and 12
+//(square 2^exponent matrix, as in the original benchmarks) or an explicit "<rows>x<cols>" size such
+//as 1000x700 (returns 0 if the argument is not valid)
+static inline int parseMatrixSize(const char *arg, int *rows, int *cols) {
+    char *end;
+    long first = strtol(arg, &end, 10);
+
+    if (*end == '\0') {
+        if (first < 4 || first > 12) {
+            return 0;
+        }
+        *rows = 1 << first;
+        *cols = 1 << first;
+        return 1;
+    }
+
+    if (*end != 'x') {
+        return 0;
+    }
+    long second = strtol(end + 1, &end, 10);
+    if (*end != '\0' || first < 1 || second < 1 || first * second > INT_MAX) {
+        return 0;
+    }
+    *rows = (int)first;
+    *cols = (int)second;
+    return 1;
+}
+
+//reads the padding of the rows from a command line argument: "auto" (MATRIX_AUTO_PADDING floats)
+//or a number of floats (returns -1 if the argument is not valid)
+static inline int parsePadding(const char *arg) {
+    char *end;
+    long padding;
+
+    if (strcmp(arg, "auto") == 0) {
+        return MATRIX_AUTO_PADDING;
+    }
+    padding = strtol(arg, &end, 10);
+    if (*end != '\0' || padding < 0 || padding > 4096) {
+        return -1;
+    }
+    return (int)padding;
+}
+
+#endif
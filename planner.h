@@ -0,0 +1,280 @@
+#ifndef PLANNER_H
+#define PLANNER_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "transpose.h"
+
+// A transposition planner in the style of FFTW: planTranspose tries the kernels of libtranspose on matrices
+// of the given size and leading dimensions, keeps the fastest combination of kernel, tile side, number of
+// threads and schedule in a plan, and executeTransposePlan then runs it with no choice left to make.
+// The threads are OpenMP ones: the program has to be compiled with -fopenmp to have more than one,
+// otherwise every plan is sequential.
+
+// PLAN_ESTIMATE returns at once the kernel matTransposeAuto would use; PLAN_MEASURE times the candidates
+#define PLAN_ESTIMATE 0
+#define PLAN_MEASURE 1
+
+// How the rows of the matrix are shared among the threads: one band per thread, or bands of one tile
+// handed out to the threads as they finish the previous one
+#define PLAN_SCHEDULE_STATIC 0
+#define PLAN_SCHEDULE_DYNAMIC 1
+
+// Every candidate is called until it has run for at least this time (in seconds), to get above the
+// resolution of gettimeofday on the small sizes
+#define PLAN_MIN_TIME 2e-3
+
+// The plan of the transposition of a rows x cols matrix (rows lds floats apart) into its transpose (rows
+// ldd floats apart)
+typedef struct {
+    int rows, cols, lds, ldd;
+    const TransposePath *path;
+    int tile;
+    int threads;
+    int schedule;
+    // seconds per call measured while planning (0 for PLAN_ESTIMATE)
+    double time;
+    // 1 if the plan was read from the wisdom instead of measured
+    int wisdom;
+} TransposePlan;
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//calls the fixed size kernel of libtranspose, with the signature of the tiled kernels (the tile is fixed too);
+//a matrix the kernel turns down (another size, padded) goes through the AVX2 tiled kernel with the tile instead
+static inline void transposeFixedSizePlanned(const Matrix *matrix, Matrix *transpose, int tile) {
+    if (!matTransposeFixedSize(matrix, transpose)) {
+        matTransposeAVX2Tiled(matrix, transpose, tile);
+    }
+}
+
+// A candidate of its own for the square sizes 16 to 128 (sequential, unpadded only)
+static const TransposePath plan_fixed_size_path = {"fixed", "fixed size (unrolled 8x8 AVX2 blocks)", NULL, transposeFixedSizePlanned};
+
+//returns the name of the schedule of a plan
+static inline const char *planScheduleName(int schedule) {
+    return (schedule == PLAN_SCHEDULE_DYNAMIC) ? "dynamic" : "static";
+}
+
+//transposes the band of (at most) band rows of the matrix starting at first into the band of columns of the
+//transpose starting at first, as a matrix of its own
+static inline void transposeBandPlanned(const TransposePlan *plan, const Matrix *matrix, Matrix *transpose, int first, int band) {
+    int last = (first + band < matrix->rows) ? first + band : matrix->rows;
+    const Matrix src = {matrix->data + (size_t)first * matrix->ld, last - first, matrix->cols, matrix->ld, matrix->pages};
+    Matrix dst = {transpose->data + first, transpose->rows, last - first, transpose->ld, transpose->pages};
+    plan->path->transposeTiled(&src, &dst, plan->tile);
+}
+
+//runs the plan: transposes the matrix (of the size and leading dimension it was planned for) into transpose
+static inline void executeTransposePlan(const TransposePlan *plan, const Matrix *matrix, Matrix *transpose) {
+#ifdef _OPENMP
+    if (plan->threads > 1) {
+        // Each thread transposes bands of whole tiles: a single one per thread, or one tile high if dynamic
+        int band = (plan->schedule == PLAN_SCHEDULE_DYNAMIC) ? plan->tile : ((matrix->rows + plan->threads - 1) / plan->threads + plan->tile - 1) / plan->tile * plan->tile;
+        int bands = (matrix->rows + band - 1) / band;
+
+        if (plan->schedule == PLAN_SCHEDULE_DYNAMIC) {
+            #pragma omp parallel for num_threads(plan->threads) schedule(dynamic)
+            for (int b = 0; b < bands; b++) {
+                transposeBandPlanned(plan, matrix, transpose, b * band, band);
+            }
+        } else {
+            #pragma omp parallel for num_threads(plan->threads) schedule(static)
+            for (int b = 0; b < bands; b++) {
+                transposeBandPlanned(plan, matrix, transpose, b * band, band);
+            }
+        }
+        return;
+    }
+#endif
+    // Sequential plans, and every plan in a program compiled without -fopenmp
+    plan->path->transposeTiled(matrix, transpose, plan->tile);
+}
+
+//returns the average time (in seconds) of one execution of the plan on M and T
+static inline double timeTransposePlan(const TransposePlan *plan, const Matrix *M, Matrix *T) {
+    // First call outside of the timing, to bring the matrices into the caches and wake the threads up
+    executeTransposePlan(plan, M, T);
+
+    struct timeval start, end;
+    double elapsed = 0.0;
+    int calls = 0;
+
+    #ifdef _WIN32
+        mingw_gettimeofday(&start, NULL);
+    #else
+        gettimeofday(&start, NULL);
+    #endif
+    while (elapsed < PLAN_MIN_TIME || calls < 3) {
+        executeTransposePlan(plan, M, T);
+        calls++;
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+        elapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) * 1e-6;
+    }
+    return elapsed / calls;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%%%%%% WISDOM %%%%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//stores a measured plan in the wisdom of libtranspose, replacing the entry of the same sizes on this CPU if
+//there is one. Returns 0 if the wisdom is full
+static inline int rememberTransposeWisdom(const TransposePlan *plan, int max_threads) {
+    TransposeWisdom entry;
+    snprintf(entry.cpu, sizeof(entry.cpu), "%s", transposeCpuModel());
+    entry.rows = plan->rows;
+    entry.cols = plan->cols;
+    entry.lds = plan->lds;
+    entry.ldd = plan->ldd;
+    entry.max_threads = max_threads;
+    snprintf(entry.path, sizeof(entry.path), "%s", plan->path->name);
+    entry.tile = plan->tile;
+    entry.threads = plan->threads;
+    entry.schedule = plan->schedule;
+    entry.time = plan->time;
+    return storeTransposeWisdom(&entry);
+}
+
+//fills the plan from the wisdom, if it has an entry for its sizes on this CPU with a kernel the CPU still
+//supports and settings that kernel can run with. Returns 0 otherwise, leaving the plan as it was
+static inline int recallTransposeWisdom(TransposePlan *plan, int max_threads) {
+    const TransposeWisdom *entry = findTransposeWisdom(transposeCpuModel(), plan->rows, plan->cols, plan->lds, plan->ldd, max_threads);
+    if (entry == NULL) {
+        return 0;
+    }
+    const TransposePath *path = (strcmp(entry->path, plan_fixed_size_path.name) == 0) ? &plan_fixed_size_path : selectTransposePath(entry->path);
+    if (path == NULL || entry->tile <= 0 || entry->threads < 1) {
+        return 0;
+    }
+    // The fixed size kernel transposes only unpadded square matrices of its own side, on one thread
+    if (path == &plan_fixed_size_path && (entry->threads != 1 || entry->tile != plan->rows || plan->rows != plan->cols ||
+                                          plan->lds != plan->cols || plan->ldd != plan->rows)) {
+        return 0;
+    }
+    plan->path = path;
+    plan->tile = entry->tile;
+    plan->threads = entry->threads;
+    plan->schedule = entry->schedule;
+    plan->time = entry->time;
+    plan->wisdom = 1;
+    return 1;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%%%%%% PLANNING %%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//plans the transposition of a rows x cols matrix with rows lds floats apart into a transpose with rows ldd
+//floats apart, with at most max_threads threads (0 for all those OpenMP would use). With PLAN_MEASURE the
+//candidates are timed in two rounds, to keep the planning short: first every SIMD kernel supported by the CPU
+//with tiles of 16 to 128 on one thread (and the fixed size kernel if there is one), then, for the fastest
+//of them, every power of two number of threads with both schedules. A plan found in the wisdom is returned
+//without timing anything, and a measured one is added to the wisdom. Returns NULL if the sizes are not valid
+//or the matrices used for the timing cannot be allocated; the plan is freed with destroyTransposePlan
+static inline TransposePlan *planTranspose(int rows, int cols, int lds, int ldd, int max_threads, int flags) {
+    if (rows <= 0 || cols <= 0 || lds < cols || ldd < rows) {
+        return NULL;
+    }
+    TransposePlan *plan = malloc(sizeof(TransposePlan));
+    if (plan == NULL) {
+        return NULL;
+    }
+    TransposePlan candidate = {rows, cols, lds, ldd, selectTransposePath(NULL), 32, 1, PLAN_SCHEDULE_STATIC, 0.0, 0};
+    *plan = candidate;
+    if (flags == PLAN_ESTIMATE) {
+        return plan;
+    }
+
+    // The limit of threads is part of the key of the wisdom: 0 is replaced by the number it stands for
+#ifdef _OPENMP
+    if (max_threads <= 0) {
+        max_threads = omp_get_max_threads();
+    }
+#else
+    max_threads = 1;
+#endif
+    if (recallTransposeWisdom(plan, max_threads)) {
+        return plan;
+    }
+
+    Matrix M, T;
+    if (!allocMatrixPadded(&M, rows, cols, lds) || !allocMatrixPadded(&T, cols, rows, ldd)) {
+        free(plan);
+        return NULL;
+    }
+    initializeMatrix(&M);
+    plan->time = timeTransposePlan(plan, &M, &T);
+
+    // First round: kernel and tile, sequential (every x86-64 CPU has SSE2, the scalar kernel is never faster)
+    const char *path_names[] = {"sse", "avx2", "avx512"};
+    const int tiles[] = {16, 32, 64, 128};
+    for (int p = 0; p < (int)(sizeof(path_names) / sizeof(path_names[0])); p++) {
+        candidate.path = selectTransposePath(path_names[p]);
+        if (candidate.path == NULL) {
+            continue;
+        }
+        for (int t = 0; t < (int)(sizeof(tiles) / sizeof(tiles[0])); t++) {
+            candidate.tile = tiles[t];
+            candidate.time = timeTransposePlan(&candidate, &M, &T);
+            if (candidate.time < plan->time) {
+                *plan = candidate;
+            }
+        }
+    }
+    if (matTransposeFixedSize(&M, &T)) {
+        candidate.path = &plan_fixed_size_path;
+        candidate.tile = rows;
+        candidate.time = timeTransposePlan(&candidate, &M, &T);
+        if (candidate.time < plan->time) {
+            *plan = candidate;
+        }
+    }
+
+    // Second round: threads and schedule for the best kernel (the fixed size one works on the whole matrix only)
+#ifdef _OPENMP
+    if (plan->path != &plan_fixed_size_path) {
+        candidate = *plan;
+        for (int threads = 2; threads <= max_threads; threads *= 2) {
+            for (int schedule = PLAN_SCHEDULE_STATIC; schedule <= PLAN_SCHEDULE_DYNAMIC; schedule++) {
+                candidate.threads = threads;
+                candidate.schedule = schedule;
+                candidate.time = timeTransposePlan(&candidate, &M, &T);
+                if (candidate.time < plan->time) {
+                    *plan = candidate;
+                }
+            }
+        }
+    }
+#endif
+
+    freeMatrix(&M);
+    freeMatrix(&T);
+    rememberTransposeWisdom(plan, max_threads);
+    return plan;
+}
+
+//frees a plan returned by planTranspose
+static inline void destroyTransposePlan(TransposePlan *plan) {
+    free(plan);
+}
+
+#endif
@@ -0,0 +1,503 @@
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <immintrin.h>
+
+// Every kernel carries the instruction set it needs as a target attribute: programs built with -mavx2 or
+// -mavx512f inline them as before, while a program built without those flags can still call them after
+// checking at run time that the CPU supports them (see transposition_dispatch.c)
+#define SIMD_TARGET_SSE __attribute__((target("sse2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%% REGISTER KERNELS %%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//transposes the 4x4 block starting at src (rows lds floats apart) into dst (rows ldd floats apart)
+static inline SIMD_TARGET_SSE void transposeBlock4x4(const float *src, int lds, float *dst, int ldd) {
+    // loads 4 floats at time into row0, row1, row2, row3 --m128 registers
+    __m128 row0 = _mm_loadu_ps(src);  //row0 = (matrix[i][j], matrix[i][j+1], matrix[i][j+2], matrix[i][j+3])
+    __m128 row1 = _mm_loadu_ps(src + lds);
+    __m128 row2 = _mm_loadu_ps(src + 2 * (size_t)lds);
+    __m128 row3 = _mm_loadu_ps(src + 3 * (size_t)lds);
+
+    // Rearrange the rows, by interleaving the inputs lower and higher parts
+    __m128 tmp0 = _mm_unpacklo_ps(row0, row1);  //tmp0 will contain the lower part of row0 and row1 interleaved
+    __m128 tmp1 = _mm_unpackhi_ps(row0, row1);  //tmp1 will contain the higher part of row0 and row1 interleaved
+    __m128 tmp2 = _mm_unpacklo_ps(row2, row3);
+    __m128 tmp3 = _mm_unpackhi_ps(row2, row3);
+
+    // Rearrange the tmp register by interleaving the inputs lower and higher parts
+    __m128 col0 = _mm_movelh_ps(tmp0, tmp2);  //col0 will contain, in order, the lower part of tmp0 and lower part of tmp2
+    __m128 col1 = _mm_movehl_ps(tmp2, tmp0);  //col1 will contain, in order, the higher part of tmp0 and the higher part of tmp2
+    __m128 col2 = _mm_movelh_ps(tmp1, tmp3);
+    __m128 col3 = _mm_movehl_ps(tmp3, tmp1);
+
+    // Store transposed block in the output matrix
+    _mm_storeu_ps(dst, col0);      // Store col0 in transpose[j][i]
+    _mm_storeu_ps(dst + ldd, col1);
+    _mm_storeu_ps(dst + 2 * (size_t)ldd, col2);
+    _mm_storeu_ps(dst + 3 * (size_t)ldd, col3);
+}
+
+//same as transposeBlock4x4, first prefetching the block distance columns further along the same rows: its
+//4 source rows and the 4 lines of dst it will be written to (distance rows below dst), so that they are on
+//their way from memory while the current block is shuffled. Both blocks have to lie inside the matrices
+static inline SIMD_TARGET_SSE void transposeBlockPrefetch4x4(const float *src, int lds, float *dst, int ldd, int distance) {
+    for (int k = 0; k < 4; k++) {
+        _mm_prefetch((const char *)(src + (size_t)k * lds + distance), _MM_HINT_T0);
+        _mm_prefetch((const char *)(dst + (size_t)(k + distance) * ldd), _MM_HINT_T0);
+    }
+
+    transposeBlock4x4(src, lds, dst, ldd);
+}
+
+// %%%%%%%%%%%% AVX2: compile with flag -mavx2 or check the CPU at run time %%%%%%%%%%%%
+
+//mask with the sign bit set in the first count lanes (count between 0 and 4), for the masked loads and stores
+static inline SIMD_TARGET_AVX2 __m128i laneMask4(int count) {
+    return _mm_cmpgt_epi32(_mm_set1_epi32(count), _mm_setr_epi32(0, 1, 2, 3));
+}
+
+//transposes a partial block of rows x cols elements (both at most 4) at the right or bottom edge of the
+//matrix: masked loads and stores never touch the elements outside the block
+static inline SIMD_TARGET_AVX2 void transposeBlockPartial4x4(const float *src, int lds, float *dst, int ldd, int rows, int cols) {
+    __m128i load_mask = laneMask4(cols);
+    __m128i store_mask = laneMask4(rows);
+    __m128 row[4];
+
+    // the missing rows are left to zero: they only end up in the masked out lanes
+    for (int k = 0; k < 4; k++) {
+        row[k] = (k < rows) ? _mm_maskload_ps(src + (size_t)k * lds, load_mask) : _mm_setzero_ps();
+    }
+
+    _MM_TRANSPOSE4_PS(row[0], row[1], row[2], row[3]);
+
+    for (int k = 0; k < cols; k++) {
+        _mm_maskstore_ps(dst + (size_t)k * ldd, store_mask, row[k]);
+    }
+}
+
+//transposes in registers the 8x8 block held in row[0..7]: at the end row[k] contains the k-th column.
+//Every step works on whole 256-bit registers: 8 unpacks, 8 shuffles and 8 lane permutes
+static inline SIMD_TARGET_AVX2 void transpose8x8Registers(__m256 row[8]) {
+    // Rearrange the rows, by interleaving the inputs lower and higher parts (2x2 blocks in every 128-bit lane)
+    __m256 tmp0 = _mm256_unpacklo_ps(row[0], row[1]);  // [0, 8, 1, 9 | 4, 12, 5, 13]
+    __m256 tmp1 = _mm256_unpackhi_ps(row[0], row[1]);  // [2, 10, 3, 11 | 6, 14, 7, 15]
+    __m256 tmp2 = _mm256_unpacklo_ps(row[2], row[3]);  // [16, 24, 17, 25 | 20, 28, 21, 29]
+    __m256 tmp3 = _mm256_unpackhi_ps(row[2], row[3]);  // [18, 26, 19, 27 | 22, 30, 23, 31]
+    __m256 tmp4 = _mm256_unpacklo_ps(row[4], row[5]);
+    __m256 tmp5 = _mm256_unpackhi_ps(row[4], row[5]);
+    __m256 tmp6 = _mm256_unpacklo_ps(row[6], row[7]);
+    __m256 tmp7 = _mm256_unpackhi_ps(row[6], row[7]);
+
+    // Pick 64-bit pairs from two interleaved rows: 4x4 blocks transposed inside every 128-bit lane
+    __m256 quad0 = _mm256_shuffle_ps(tmp0, tmp2, _MM_SHUFFLE(1, 0, 1, 0));  // [0, 8, 16, 24 | 4, 12, 20, 28]
+    __m256 quad1 = _mm256_shuffle_ps(tmp0, tmp2, _MM_SHUFFLE(3, 2, 3, 2));  // [1, 9, 17, 25 | 5, 13, 21, 29]
+    __m256 quad2 = _mm256_shuffle_ps(tmp1, tmp3, _MM_SHUFFLE(1, 0, 1, 0));  // [2, 10, 18, 26 | 6, 14, 22, 30]
+    __m256 quad3 = _mm256_shuffle_ps(tmp1, tmp3, _MM_SHUFFLE(3, 2, 3, 2));  // [3, 11, 19, 27 | 7, 15, 23, 31]
+    __m256 quad4 = _mm256_shuffle_ps(tmp4, tmp6, _MM_SHUFFLE(1, 0, 1, 0));  // [32, 40, 48, 56 | 36, 44, 52, 60]
+    __m256 quad5 = _mm256_shuffle_ps(tmp4, tmp6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 quad6 = _mm256_shuffle_ps(tmp5, tmp7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 quad7 = _mm256_shuffle_ps(tmp5, tmp7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    // Join the lower lanes (columns 0 to 3) and the higher lanes (columns 4 to 7) of the two halves of the block
+    row[0] = _mm256_permute2f128_ps(quad0, quad4, 0x20);  // [0, 8, 16, 24, 32, 40, 48, 56]
+    row[1] = _mm256_permute2f128_ps(quad1, quad5, 0x20);
+    row[2] = _mm256_permute2f128_ps(quad2, quad6, 0x20);
+    row[3] = _mm256_permute2f128_ps(quad3, quad7, 0x20);
+    row[4] = _mm256_permute2f128_ps(quad0, quad4, 0x31);  // [4, 12, 20, 28, 36, 44, 52, 60]
+    row[5] = _mm256_permute2f128_ps(quad1, quad5, 0x31);
+    row[6] = _mm256_permute2f128_ps(quad2, quad6, 0x31);
+    row[7] = _mm256_permute2f128_ps(quad3, quad7, 0x31);
+}
+
+//same as transpose8x8Registers, the first version: every interleaved row is split into its 128-bit halves,
+//the halves are shuffled as 4x4 blocks and joined again (16 extracts, 16 128-bit shuffles and 8 inserts).
+//Kept as the reference of the benchmarks of the register kernels (see transposition_vectorization_8.c)
+static inline SIMD_TARGET_AVX2 void transpose8x8RegistersSplit(__m256 row[8]) {
+    // Rearrange the rows, by interleaving the inputs lower and higher parts
+    __m256 tmp0 = _mm256_unpacklo_ps(row[0], row[1]);  //tmp0 will contain the lower part of row0 and row1 interleaved
+    __m256 tmp1 = _mm256_unpackhi_ps(row[0], row[1]);  //tmp1 will contain the higher part of row0 and row1 interleaved
+    __m256 tmp2 = _mm256_unpacklo_ps(row[2], row[3]);
+    __m256 tmp3 = _mm256_unpackhi_ps(row[2], row[3]);
+    __m256 tmp4 = _mm256_unpacklo_ps(row[4], row[5]);
+    __m256 tmp5 = _mm256_unpackhi_ps(row[4], row[5]);
+    __m256 tmp6 = _mm256_unpacklo_ps(row[6], row[7]);
+    __m256 tmp7 = _mm256_unpackhi_ps(row[6], row[7]);
+
+    //Subdivide each row in rows of 4 floats
+    __m128 low_tmp0 = _mm256_castps256_ps128(tmp0);        // [0, 8, 1, 9]
+    __m128 high_tmp0 = _mm256_extractf128_ps(tmp0, 1);     // [4, 12, 5, 13]
+    __m128 low_tmp1 = _mm256_castps256_ps128(tmp1);        // [2, 10, 3, 11]
+    __m128 high_tmp1 = _mm256_extractf128_ps(tmp1, 1);     // [6, 14, 7, 15]
+    __m128 low_tmp2 = _mm256_castps256_ps128(tmp2);        // [16, 24, 17, 25]
+    __m128 high_tmp2 = _mm256_extractf128_ps(tmp2, 1);     // [20, 28, 21, 29]
+    __m128 low_tmp3 = _mm256_castps256_ps128(tmp3);        // [18, 26, 19, 27]
+    __m128 high_tmp3 = _mm256_extractf128_ps(tmp3, 1);     // [22, 30, 23, 31]
+    __m128 low_tmp4 = _mm256_castps256_ps128(tmp4);        // [32, 40, 33, 41]
+    __m128 high_tmp4 = _mm256_extractf128_ps(tmp4, 1);     // [36, 44, 37, 45]
+    __m128 low_tmp5 = _mm256_castps256_ps128(tmp5);        // [34, 42, 35, 43]
+    __m128 high_tmp5 = _mm256_extractf128_ps(tmp5, 1);     // [38, 46, 39, 47]
+    __m128 low_tmp6 = _mm256_castps256_ps128(tmp6);        // [48, 56, 49, 57]
+    __m128 high_tmp6 = _mm256_extractf128_ps(tmp6, 1);     // [52, 60, 53, 61]
+    __m128 low_tmp7 = _mm256_castps256_ps128(tmp7);        // [50, 58, 51, 59]
+    __m128 high_tmp7 = _mm256_extractf128_ps(tmp7, 1);     // [54, 62, 55, 63]
+
+    // Rearrange the tmp register by interleaving the inputs lower and higher parts
+    __m128 col0low = _mm_movelh_ps(low_tmp0, low_tmp2);
+    __m128 col0high = _mm_movelh_ps(low_tmp4, low_tmp6);
+    __m128 col1low = _mm_movehl_ps(low_tmp2, low_tmp0);
+    __m128 col1high = _mm_movehl_ps(low_tmp6, low_tmp4);
+    __m128 col2low = _mm_movelh_ps(low_tmp1, low_tmp3);
+    __m128 col2high = _mm_movelh_ps(low_tmp5, low_tmp7);
+    __m128 col3low = _mm_movehl_ps(low_tmp3, low_tmp1);
+    __m128 col3high = _mm_movehl_ps(low_tmp7, low_tmp5);
+    __m128 col4low = _mm_movelh_ps(high_tmp0, high_tmp2);
+    __m128 col4high = _mm_movelh_ps(high_tmp4, high_tmp6);
+    __m128 col5low = _mm_movehl_ps(high_tmp2, high_tmp0);
+    __m128 col5high = _mm_movehl_ps(high_tmp6, high_tmp4);
+    __m128 col6low = _mm_movelh_ps(high_tmp1, high_tmp3);
+    __m128 col6high = _mm_movelh_ps(high_tmp5, high_tmp7);
+    __m128 col7low = _mm_movehl_ps(high_tmp3, high_tmp1);
+    __m128 col7high = _mm_movehl_ps(high_tmp7, high_tmp5);
+    
+    // Merge together again the lower and higher parts of the columns
+    row[0] = _mm256_set_m128(col0high, col0low);
+    row[1] = _mm256_set_m128(col1high, col1low);   
+    row[2] = _mm256_set_m128(col2high, col2low);
+    row[3] = _mm256_set_m128(col3high, col3low);   
+    row[4] = _mm256_set_m128(col4high, col4low);
+    row[5] = _mm256_set_m128(col5high, col5low);
+    row[6] = _mm256_set_m128(col6high, col6low);
+    row[7] = _mm256_set_m128(col7high, col7low);
+}
+
+//transposes the 8x8 block starting at src (rows lds floats apart) into dst (rows ldd floats apart)
+static inline SIMD_TARGET_AVX2 void transposeBlock8x8(const float *src, int lds, float *dst, int ldd) {
+    __m256 row[8];
+
+    // loads 8 floats at time, one row of the block per __m256 register
+    for (int k = 0; k < 8; k++) {
+        row[k] = _mm256_loadu_ps(src + (size_t)k * lds);
+    }
+
+    transpose8x8Registers(row);
+
+    // Store transposed block: the k-th column of src becomes the k-th row of dst
+    for (int k = 0; k < 8; k++) {
+        _mm256_storeu_ps(dst + (size_t)k * ldd, row[k]);
+    }
+}
+
+//same as transposeBlock8x8 with the first register kernel (transpose8x8RegistersSplit), for the benchmarks
+static inline SIMD_TARGET_AVX2 void transposeBlockSplit8x8(const float *src, int lds, float *dst, int ldd) {
+    __m256 row[8];
+
+    for (int k = 0; k < 8; k++) {
+        row[k] = _mm256_loadu_ps(src + (size_t)k * lds);
+    }
+
+    transpose8x8RegistersSplit(row);
+
+    for (int k = 0; k < 8; k++) {
+        _mm256_storeu_ps(dst + (size_t)k * ldd, row[k]);
+    }
+}
+
+//transposes the 16x16 block starting at src (rows lds floats apart) into dst (rows ldd floats apart) as
+//four 8x8 blocks, the two of each 8 columns of src together: row k of dst gets the two halves of a
+//64-byte line one right after the other, from the top block and from the one below it
+static inline SIMD_TARGET_AVX2 void transposeBlockMacro16x16(const float *src, int lds, float *dst, int ldd) {
+    for (int j = 0; j < 16; j += 8) {
+        __m256 top[8];
+        __m256 bottom[8];
+
+        for (int k = 0; k < 8; k++) {
+            top[k] = _mm256_loadu_ps(src + (size_t)k * lds + j);
+            bottom[k] = _mm256_loadu_ps(src + (size_t)(k + 8) * lds + j);
+        }
+
+        transpose8x8Registers(top);
+        transpose8x8Registers(bottom);
+
+        for (int k = 0; k < 8; k++) {
+            _mm256_storeu_ps(dst + (size_t)(j + k) * ldd, top[k]);
+            _mm256_storeu_ps(dst + (size_t)(j + k) * ldd + 8, bottom[k]);
+        }
+    }
+}
+
+//same as transposeBlock8x8, first prefetching the 8 source rows and the 8 lines of dst of the block
+//distance columns further along the same rows (see transposeBlockPrefetch4x4)
+static inline SIMD_TARGET_AVX2 void transposeBlockPrefetch8x8(const float *src, int lds, float *dst, int ldd, int distance) {
+    for (int k = 0; k < 8; k++) {
+        _mm_prefetch((const char *)(src + (size_t)k * lds + distance), _MM_HINT_T0);
+        _mm_prefetch((const char *)(dst + (size_t)(k + distance) * ldd), _MM_HINT_T0);
+    }
+
+    transposeBlock8x8(src, lds, dst, ldd);
+}
+
+//transposes the two 8x8 blocks starting at src and 8 rows below it with non-temporal stores: every row
+//of dst receives 16 floats, i.e. a whole 64-byte line written at once straight to memory instead of being
+//read into the cache first. The rows of dst must be 64-byte aligned, and the caller has to issue an
+//_mm_sfence before the transpose is read by another thread
+static inline SIMD_TARGET_AVX2 void transposeBlockPairStream8x8(const float *src, int lds, float *dst, int ldd) {
+    __m256 top[8];
+    __m256 bottom[8];
+
+    for (int k = 0; k < 8; k++) {
+        top[k] = _mm256_loadu_ps(src + (size_t)k * lds);
+        bottom[k] = _mm256_loadu_ps(src + (size_t)(k + 8) * lds);
+    }
+
+    transpose8x8Registers(top);
+    transpose8x8Registers(bottom);
+
+    // the two halves of each line are stored one right after the other, so the write-combining buffer is filled in full
+    for (int k = 0; k < 8; k++) {
+        _mm256_stream_ps(dst + (size_t)k * ldd, top[k]);
+        _mm256_stream_ps(dst + (size_t)k * ldd + 8, bottom[k]);
+    }
+}
+
+//transposes in place the 8x8 block on the diagonal starting at block (rows ld floats apart)
+static inline SIMD_TARGET_AVX2 void transposeBlockInPlace8x8(float *block, int ld) {
+    __m256 row[8];
+
+    for (int k = 0; k < 8; k++) {
+        row[k] = _mm256_loadu_ps(block + (size_t)k * ld);
+    }
+
+    transpose8x8Registers(row);
+
+    for (int k = 0; k < 8; k++) {
+        _mm256_storeu_ps(block + (size_t)k * ld, row[k]);
+    }
+}
+
+//swaps the 8x8 blocks a = (i, j) and b = (j, i) of a square matrix transposing both of them:
+//the two blocks are loaded and transposed in registers before anything is written back
+static inline SIMD_TARGET_AVX2 void swapTransposeBlocks8x8(float *a, float *b, int ld) {
+    __m256 row_a[8];
+    __m256 row_b[8];
+
+    for (int k = 0; k < 8; k++) {
+        row_a[k] = _mm256_loadu_ps(a + (size_t)k * ld);
+        row_b[k] = _mm256_loadu_ps(b + (size_t)k * ld);
+    }
+
+    transpose8x8Registers(row_a);
+    transpose8x8Registers(row_b);
+
+    for (int k = 0; k < 8; k++) {
+        _mm256_storeu_ps(a + (size_t)k * ld, row_b[k]);
+        _mm256_storeu_ps(b + (size_t)k * ld, row_a[k]);
+    }
+}
+
+//mask with the sign bit set in the first count lanes (count between 0 and 8), for the masked loads and stores
+static inline SIMD_TARGET_AVX2 __m256i laneMask8(int count) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+//transposes a partial block of rows x cols elements (both at most 8) at the right or bottom edge of the
+//matrix: masked loads and stores never touch the elements outside the block
+static inline SIMD_TARGET_AVX2 void transposeBlockPartial8x8(const float *src, int lds, float *dst, int ldd, int rows, int cols) {
+    __m256i load_mask = laneMask8(cols);
+    __m256i store_mask = laneMask8(rows);
+    __m256 row[8];
+
+    // the missing rows are left to zero: they only end up in the masked out lanes
+    for (int k = 0; k < 8; k++) {
+        row[k] = (k < rows) ? _mm256_maskload_ps(src + (size_t)k * lds, load_mask) : _mm256_setzero_ps();
+    }
+
+    transpose8x8Registers(row);
+
+    for (int k = 0; k < cols; k++) {
+        _mm256_maskstore_ps(dst + (size_t)k * ldd, store_mask, row[k]);
+    }
+}
+
+//same as transposeBlock8x8, multiplying every element by alpha on the way (dst = alpha * src^T)
+static inline SIMD_TARGET_AVX2 void transposeBlockScaled8x8(const float *src, int lds, float *dst, int ldd, float alpha) {
+    __m256 scale = _mm256_set1_ps(alpha);
+    __m256 row[8];
+
+    for (int k = 0; k < 8; k++) {
+        row[k] = _mm256_loadu_ps(src + (size_t)k * lds);
+    }
+
+    transpose8x8Registers(row);
+
+    for (int k = 0; k < 8; k++) {
+        _mm256_storeu_ps(dst + (size_t)k * ldd, _mm256_mul_ps(row[k], scale));
+    }
+}
+
+//same as transposeBlockPartial8x8, multiplying every element by alpha on the way
+static inline SIMD_TARGET_AVX2 void transposeBlockPartialScaled8x8(const float *src, int lds, float *dst, int ldd, int rows, int cols, float alpha) {
+    __m256i load_mask = laneMask8(cols);
+    __m256i store_mask = laneMask8(rows);
+    __m256 scale = _mm256_set1_ps(alpha);
+    __m256 row[8];
+
+    for (int k = 0; k < 8; k++) {
+        row[k] = (k < rows) ? _mm256_maskload_ps(src + (size_t)k * lds, load_mask) : _mm256_setzero_ps();
+    }
+
+    transpose8x8Registers(row);
+
+    for (int k = 0; k < cols; k++) {
+        _mm256_maskstore_ps(dst + (size_t)k * ldd, store_mask, _mm256_mul_ps(row[k], scale));
+    }
+}
+
+//same as swapTransposeBlocks8x8 for the partial blocks at the edge of a square matrix: a = (i, j) is
+//rows x cols and b = (j, i) is cols x rows (a == b transposes a partial diagonal block in place)
+static inline SIMD_TARGET_AVX2 void swapTransposeBlocksPartial8x8(float *a, float *b, int ld, int rows, int cols) {
+    __m256i rows_mask = laneMask8(rows);
+    __m256i cols_mask = laneMask8(cols);
+    __m256 row_a[8];
+    __m256 row_b[8];
+
+    for (int k = 0; k < 8; k++) {
+        row_a[k] = (k < rows) ? _mm256_maskload_ps(a + (size_t)k * ld, cols_mask) : _mm256_setzero_ps();
+        row_b[k] = (k < cols) ? _mm256_maskload_ps(b + (size_t)k * ld, rows_mask) : _mm256_setzero_ps();
+    }
+
+    transpose8x8Registers(row_a);
+    transpose8x8Registers(row_b);
+
+    for (int k = 0; k < rows; k++) {
+        _mm256_maskstore_ps(a + (size_t)k * ld, cols_mask, row_b[k]);
+    }
+    for (int k = 0; k < cols; k++) {
+        _mm256_maskstore_ps(b + (size_t)k * ld, rows_mask, row_a[k]);
+    }
+}
+
+//loads the block a = (i, j) of rows x cols floats into row_a and its mirror b = (j, i) of cols x rows floats
+//into row_b (rows ld floats apart, rows and cols at most 8), then transposes row_b in registers: row_a[k] and
+//row_b[k] hold the pairs of row k of a. Full blocks are read with contiguous row loads, the partial ones at
+//the edge of a square matrix with masked loads, the lanes outside the blocks zero on both sides
+static inline SIMD_TARGET_AVX2 void loadMirrorBlocks8x8(const float *a, const float *b, int ld, int rows, int cols, __m256 row_a[8], __m256 row_b[8]) {
+    if (rows == 8 && cols == 8) {
+        for (int k = 0; k < 8; k++) {
+            row_a[k] = _mm256_loadu_ps(a + (size_t)k * ld);
+            row_b[k] = _mm256_loadu_ps(b + (size_t)k * ld);
+        }
+    } else {
+        __m256i rows_mask = laneMask8(rows);
+        __m256i cols_mask = laneMask8(cols);
+        for (int k = 0; k < 8; k++) {
+            row_a[k] = (k < rows) ? _mm256_maskload_ps(a + (size_t)k * ld, cols_mask) : _mm256_setzero_ps();
+            row_b[k] = (k < cols) ? _mm256_maskload_ps(b + (size_t)k * ld, rows_mask) : _mm256_setzero_ps();
+        }
+    }
+
+    transpose8x8Registers(row_b);
+}
+
+//returns 1 if the 8x8 block a is the transpose of the 8x8 block b (a == b checks a diagonal block), rows ld
+//floats apart: all the lanes of the mirrors are compared before one movemask
+static inline SIMD_TARGET_AVX2 int symmetricBlocks8x8(const float *a, const float *b, int ld) {
+    __m256 row_a[8];
+    __m256 row_b[8];
+    loadMirrorBlocks8x8(a, b, ld, 8, 8, row_a, row_b);
+
+    // the lanes that differ are accumulated, so a single movemask decides for the whole block
+    __m256 differ = _mm256_cmp_ps(row_a[0], row_b[0], _CMP_NEQ_OQ);
+    for (int k = 1; k < 8; k++) {
+        differ = _mm256_or_ps(differ, _mm256_cmp_ps(row_a[k], row_b[k], _CMP_NEQ_OQ));
+    }
+    return _mm256_movemask_ps(differ) == 0;
+}
+
+//same as symmetricBlocks8x8 for the partial blocks at the edge of a square matrix: a = (i, j) is rows x cols
+//and b = (j, i) is cols x rows
+static inline SIMD_TARGET_AVX2 int symmetricBlocksPartial8x8(const float *a, const float *b, int ld, int rows, int cols) {
+    __m256 row_a[8];
+    __m256 row_b[8];
+    loadMirrorBlocks8x8(a, b, ld, rows, cols, row_a, row_b);
+
+    __m256 differ = _mm256_setzero_ps();
+    for (int k = 0; k < rows; k++) {
+        differ = _mm256_or_ps(differ, _mm256_cmp_ps(row_a[k], row_b[k], _CMP_NEQ_OQ));
+    }
+    return _mm256_movemask_ps(differ) == 0;
+}
+
+// %%%%%%%%%%%% AVX-512: compile with flag -mavx512f or check the CPU at run time %%%%%%%%%%%%
+
+//transposes in registers the 16x16 block held in row[0..15]: at the end row[k] contains the k-th column
+static inline SIMD_TARGET_AVX512 void transpose16x16Registers(__m512 row[16]) {
+    __m512 tmp[16];
+
+    // Interleave pairs of rows: 2x2 blocks transposed inside every 128-bit lane
+    for (int k = 0; k < 16; k += 2) {
+        tmp[k] = _mm512_unpacklo_ps(row[k], row[k + 1]);
+        tmp[k + 1] = _mm512_unpackhi_ps(row[k], row[k + 1]);
+    }
+
+    // Pick 64-bit pairs from two interleaved rows: 4x4 blocks transposed inside every 128-bit lane
+    for (int k = 0; k < 16; k += 4) {
+        row[k] = _mm512_shuffle_ps(tmp[k], tmp[k + 2], _MM_SHUFFLE(1, 0, 1, 0));
+        row[k + 1] = _mm512_shuffle_ps(tmp[k], tmp[k + 2], _MM_SHUFFLE(3, 2, 3, 2));
+        row[k + 2] = _mm512_shuffle_ps(tmp[k + 1], tmp[k + 3], _MM_SHUFFLE(1, 0, 1, 0));
+        row[k + 3] = _mm512_shuffle_ps(tmp[k + 1], tmp[k + 3], _MM_SHUFFLE(3, 2, 3, 2));
+    }
+
+    // Permute whole 128-bit lanes between rows 4 apart (even lanes, then odd lanes)...
+    for (int k = 0; k < 16; k += 8) {
+        for (int l = 0; l < 4; l++) {
+            tmp[k + l] = _mm512_shuffle_f32x4(row[k + l], row[k + l + 4], 0x88);
+            tmp[k + l + 4] = _mm512_shuffle_f32x4(row[k + l], row[k + l + 4], 0xdd);
+        }
+    }
+
+    // ...and between rows 8 apart, which completes the 16x16 transposition
+    for (int l = 0; l < 8; l++) {
+        row[l] = _mm512_shuffle_f32x4(tmp[l], tmp[l + 8], 0x88);
+        row[l + 8] = _mm512_shuffle_f32x4(tmp[l], tmp[l + 8], 0xdd);
+    }
+}
+
+//transposes the 16x16 block starting at src (rows lds floats apart) into dst (rows ldd floats apart)
+static inline SIMD_TARGET_AVX512 void transposeBlock16x16(const float *src, int lds, float *dst, int ldd) {
+    __m512 row[16];
+
+    for (int k = 0; k < 16; k++) {
+        row[k] = _mm512_loadu_ps(src + (size_t)k * lds);
+    }
+
+    transpose16x16Registers(row);
+
+    for (int k = 0; k < 16; k++) {
+        _mm512_storeu_ps(dst + (size_t)k * ldd, row[k]);
+    }
+}
+
+//transposes a partial block of rows x cols elements (both at most 16) at the right or bottom edge of the
+//matrix, using the AVX-512 mask registers for the loads and the stores
+static inline SIMD_TARGET_AVX512 void transposeBlockPartial16x16(const float *src, int lds, float *dst, int ldd, int rows, int cols) {
+    __mmask16 load_mask = (__mmask16)((1u << cols) - 1);
+    __mmask16 store_mask = (__mmask16)((1u << rows) - 1);
+    __m512 row[16];
+
+    for (int k = 0; k < 16; k++) {
+        row[k] = (k < rows) ? _mm512_maskz_loadu_ps(load_mask, src + (size_t)k * lds) : _mm512_setzero_ps();
+    }
+
+    transpose16x16Registers(row);
+
+    for (int k = 0; k < cols; k++) {
+        _mm512_mask_storeu_ps(dst + (size_t)k * ldd, store_mask, row[k]);
+    }
+}
+
+#endif
@@ -1,19 +1,21 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <mpi.h>
 #include <time.h>
+#include "transpose.h"
+#include "sym_report.h"
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-// Function that initializes the matrix with random values
-void initializeSymmetricMatrix(float **matrix, int n);
-// Function that prints the original matrix
-void printMatrix(float **matrix, int n);
 // Functions that checks if the matrix is symmetric using MPI
-void checkSym(float *M_flat, int matrix_size, int start_index_local, int stop_index_local, int *start_indexes, int *stop_indexes);
+void checkSym(Matrix *M, int start_index_local, int stop_index_local, int *start_indexes, int *stop_indexes);
+// Function that reports the asymmetries of the matrix instead of aborting at the first one: every process reports on
+// its rows and rank 0 merges the reports into report
+void reportSym(Matrix *M, int start_index_local, int stop_index_local, int *start_indexes, int *stop_indexes, int max_positions, SymReport *report);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -33,26 +35,47 @@ int main(int argc, char *argv[]) {
 
     // Input validation
     if (rank == 0) {
-        if (argc != 2) {
-            printf("Please provide a matrix size as an argument.\n");
+        if (argc < 2) {
+            printf("Please provide a matrix size as an argument (options: -report <positions>, -asymmetric <pairs>).\n");
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
+    int rows = 0, cols = 0;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
         if (rank == 0) {
-            printf("Matrix size exponent must be between 4 and 12 (base is 2).\n");
+            printf("Matrix size must be an exponent between 4 and 12 (base is 2) or an explicit size such as 1000x700.\n");
         }
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
-    // Matrix size computation
-    int matrix_size = 1 << exponent;
-    int base_local_rows = matrix_size / size;
+    // Report mode: the number of positions to report (-1 for the plain check, which aborts at the first asymmetry)
+    // and the number of asymmetric pairs planted in the matrix (none by default)
+    int max_positions = -1;
+    int pairs = 0;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-report") == 0 && a + 1 < argc) {
+            max_positions = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-asymmetric") == 0 && a + 1 < argc) {
+            pairs = atoi(argv[++a]);
+        } else {
+            if (rank == 0) {
+                printf("Unknown option %s.\n", argv[a]);
+            }
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    if (max_positions > SYM_REPORT_MAX_POSITIONS || pairs < 0 || (max_positions >= 0 && rows != cols)) {
+        if (rank == 0) {
+            printf("The report needs a square matrix and at most %d positions, the asymmetric pairs cannot be negative.\n", SYM_REPORT_MAX_POSITIONS);
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    int base_local_rows = rows / size;
 
-    if( matrix_size < size ) {
+    if( rows < size ) {
         if(rank == 0) {
-            printf("Matrix size must be greater than or equal to the number of processes.\n");
+            printf("The number of rows must be greater than or equal to the number of processes.\n");
         }
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
@@ -64,8 +87,8 @@ int main(int argc, char *argv[]) {
 
     int *start_indexes = NULL;
     int *stop_indexes = NULL;
-    int start_index_local;
-    int stop_index_local;
+    int start_index_local = 0;
+    int stop_index_local = 0;
 
     if(rank==0){
         start_indexes = malloc(size * sizeof(int));
@@ -73,7 +96,7 @@ int main(int argc, char *argv[]) {
 
         for(int i = 0; i < size; i++) {
             start_indexes[i] = i * base_local_rows;
-            stop_indexes[i] = (i == size - 1) ? matrix_size-1 : (i + 1) * base_local_rows-1;
+            stop_indexes[i] = (i == size - 1) ? rows-1 : (i + 1) * base_local_rows-1;
         }
     }
 
@@ -82,15 +105,11 @@ int main(int argc, char *argv[]) {
     // ------------- MATRICES ALLOCATIONS ------------- //
     // ------------------------------------------------ //
 
-    // M is the matrix declares as duble pointer to ensure continuity with the previous codes 
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    // M_flat is the matrix flattened out
-    float *M_flat = malloc(matrix_size * matrix_size * sizeof(float));
-
-    if (rank == 0) {
-        for (int i = 0; i < matrix_size; i++) {
-            M[i] = (float *)malloc(matrix_size * sizeof(float));
-        }
+    // M is contiguous, so the buffer initialized by rank 0 is broadcast as it is (every rank needs its own copy)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Rank %d is unable to allocate the matrix.\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
     
@@ -101,31 +120,34 @@ int main(int argc, char *argv[]) {
     //Set the number of interations to have an average time
     int iterations = 50;
     double total_time = 0.0;
+    SymReport report;
 
 
     for(int i = 0; i < iterations; i++){
 
         if (rank == 0) {
-            initializeSymmetricMatrix(M, matrix_size);
-            for(int i = 0; i < matrix_size; i++) {
-                for(int j = 0; j < matrix_size; j++) {
-                    M_flat[i * matrix_size + j] = M[i][j];
-                }
+            initializeSymmetricMatrix(&M);
+            if (pairs > 0) {
+                plantAsymmetries(&M, pairs);
             }
         }
 
         // REMOVE COMMENTS TO CHECK IF THE MATRIX IS ACTUALLY SYMMETRIC OR NOT
         // if(rank == 0) {
         //     printf("The original matrix is:\n");
-        //     printMatrix(M, matrix_size);
+        //     printMatrix(&M);
         // }
         
         // Synchronize processes before starting taking the time
         MPI_Barrier(MPI_COMM_WORLD);
         double start_time = MPI_Wtime();
 
-        // Call checkSym function to check if the matrix is symmetric
-        checkSym(M_flat, matrix_size, start_index_local, stop_index_local, start_indexes, stop_indexes);
+        // Call checkSym function to check if the matrix is symmetric, or reportSym to know what is wrong with it
+        if (max_positions < 0) {
+            checkSym(&M, start_index_local, stop_index_local, start_indexes, stop_indexes);
+        } else {
+            reportSym(&M, start_index_local, stop_index_local, start_indexes, stop_indexes, max_positions, &report);
+        }
 
         double end_time = MPI_Wtime();
 
@@ -143,7 +165,13 @@ int main(int argc, char *argv[]) {
     // ------------------------------------------------ //
     if (rank == 0) {
         double average_time = total_time / iterations;
-        printf("Average time for %d * %d matrix symmetry check: %f ms\n", matrix_size, matrix_size, average_time*1000);
+        printf("Average time for %d * %d matrix symmetry %s: %f ms\n", rows, cols, (max_positions < 0) ? "check" : "report", average_time*1000);
+        if (max_positions >= 0) {
+            printf("Asymmetric pairs: %lld of %lld. Max deviation: %g. RMS deviation: %g\n", report.asymmetric, report.pairs, report.max_deviation, symReportRms(&report));
+            for (int p = 0; p < report.positions; p++) {
+                printf("    (%d, %d)\n", report.position_rows[p], report.position_cols[p]);
+            }
+        }
     }
 
     // ------------------------------------------------ //
@@ -153,13 +181,7 @@ int main(int argc, char *argv[]) {
     free(start_indexes);
     free(stop_indexes);
 
-    if(rank == 0) {
-        for (int i = 0; i < matrix_size; i++) {
-            free(M[i]);
-        }
-    }
-    free(M_flat);
-    free(M);
+    freeMatrix(&M);
 
     MPI_Finalize();
     return 0;
@@ -170,31 +192,9 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-void initializeSymmetricMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            float x = (float)rand() / RAND_MAX * 10.0f;
-            matrix[i][j] = x;
-            matrix[j][i] = x;
-            //remove the comment if you want to have a non-symmetric matrix and check whether the code works
-            //matrix[i][j] = (float)rand() / RAND_MAX * 10.0f;
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-void checkSym(float *M_flat, int matrix_size, int start_index_local, int stop_index_local, int *start_indexes, int *stop_indexes) {
-    
+void checkSym(Matrix *M, int start_index_local, int stop_index_local, int *start_indexes, int *stop_indexes) {
     // Broadcast of the entire matrix to all the processes
-    MPI_Bcast(M_flat, matrix_size * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    MPI_Bcast(M->data, M->rows * M->cols, MPI_FLOAT, 0, MPI_COMM_WORLD);
 
     // Scatter the informations about initial index and final index
     MPI_Scatter(start_indexes, 1, MPI_INT, &start_index_local, 1, MPI_INT, 0, MPI_COMM_WORLD);
@@ -203,10 +203,11 @@ void checkSym(float *M_flat, int matrix_size, int start_index_local, int stop_in
     // ------------------------------------------------ //
     // ---------- LOCAL MATRIX SYM CHECK -------------- //
     // ------------------------------------------------ //
-    int is_symmetric_local = 1;
-    for (int i = start_index_local; i <= stop_index_local; i++) { 
-        for (int j = 0; j < matrix_size; j++) { 
-            if(M_flat[i * matrix_size + j] != M_flat[j * matrix_size + i]){ 
+    // A rectangular matrix can never be symmetric, and its mirrored elements would be out of bounds
+    int is_symmetric_local = (M->rows == M->cols);
+    for (int i = start_index_local; is_symmetric_local && i <= stop_index_local; i++) { 
+        for (int j = 0; j < M->cols; j++) { 
+            if(MAT(M, i, j) != MAT(M, j, i)){ 
                 is_symmetric_local = 0;
                 break;
             } 
@@ -220,4 +221,40 @@ void checkSym(float *M_flat, int matrix_size, int start_index_local, int stop_in
         printf("\n\n\n THE MATRIX IS NOT SYMMETRIC \n\n\n");
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
-}
\ No newline at end of file
+}
+
+void reportSym(Matrix *M, int start_index_local, int stop_index_local, int *start_indexes, int *stop_indexes, int max_positions, SymReport *report) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    // Broadcast of the entire matrix and scatter of the rows of each process, as in checkSym
+    MPI_Bcast(M->data, M->rows * M->cols, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    MPI_Scatter(start_indexes, 1, MPI_INT, &start_index_local, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Scatter(stop_indexes, 1, MPI_INT, &stop_index_local, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+    // ------------------------------------------------ //
+    // ---------- LOCAL ASYMMETRY REPORT -------------- //
+    // ------------------------------------------------ //
+    // The pairs (i, j) with i < j of the local rows: every pair belongs to exactly one process
+    SymReport report_local;
+    reportAsymmetryRows(M, start_index_local, stop_index_local + 1, max_positions, &report_local);
+
+    // Gathering the local reports (plain structures, sent as bytes) on rank 0, which merges them
+    SymReport *reports = NULL;
+    if (rank == 0) {
+        reports = malloc(size * sizeof(SymReport));
+        if (reports == NULL) {
+            printf("Unable to allocate the reports of the processes.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    MPI_Gather(&report_local, sizeof(SymReport), MPI_BYTE, reports, sizeof(SymReport), MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (rank == 0) {
+        memset(report, 0, sizeof(*report));
+        for (int p = 0; p < size; p++) {
+            mergeSymReports(report, &reports[p], max_positions);
+        }
+        free(reports);
+    }
+}
@@ -2,6 +2,7 @@
 #include <stdlib.h>
 #include <mpi.h>
 #include <time.h>
+#include "transpose.h"
 #include <unistd.h>
 #ifdef _WIN32
 #include <windows.h>
@@ -10,14 +11,6 @@
 #endif
 
 
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-// %%%%% FUNCTIONS DECLARATION %%%%%% //
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-
-void initializeSymmetricMatrix(float **matrix, int n);
-void printMatrix(float **matrix, int n);
-
-
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -40,16 +33,16 @@ int main(int argc, char *argv[]) {
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
+    int rows = 0, cols = 0;
+    if (!parseMatrixSize(argv[1], &rows, &cols) || rows != cols) {
         if (rank == 0) {
-            printf("Matrix size exponent must be between 4 and 12 (base is 2).\n");
+            printf("Matrix size must be an exponent between 4 and 12 (base is 2) or an explicit square size such as 1000x1000.\n");
         }
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
-    // Matrix size computation
-    int matrix_size = 1 << exponent;
+    // Matrix size (the scattering of the columns only works for square matrices)
+    int matrix_size = rows;
     // Number of r
     int base_local_rows = matrix_size / size;
 
@@ -72,6 +65,8 @@ int main(int argc, char *argv[]) {
         rows_per_process[i] = base_local_rows + ((i == size - 1) ? matrix_size % size : 0);
         rows_elements_per_process[i] = rows_per_process[i] * matrix_size;
         rows_scatter_displs[i] = (i == 0) ? 0 : rows_scatter_displs[i - 1] +  rows_per_process[i - 1]*matrix_size;
+        // The matrix is square, so each process gets as many columns as rows
+        columns_per_process[i] = rows_per_process[i];
     }
 
 
@@ -113,19 +108,18 @@ int main(int argc, char *argv[]) {
     // ------------------------------------------------ //
 
     // Matrices for only rank 0
-    float *M_flat = NULL;
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-
+    Matrix M = {0};
     if (rank == 0) {
-        M_flat = malloc(matrix_size * matrix_size * sizeof(float));
-        for (int i = 0; i < matrix_size; i++) {
-            M[i] = (float *)malloc(matrix_size * sizeof(float));
+        if (!allocMatrix(&M, matrix_size, matrix_size)) {
+            printf("Unable to allocate the matrix.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
 
     // Matrices for all the ranks
     float *local_rows = malloc(rows_per_process[rank] * matrix_size * sizeof(float));
-    float *local_columns = malloc(rows_per_process[rank] * matrix_size * sizeof(float));
+    // (zeroed: none of the scattering methods of the columns below is enabled yet)
+    float *local_columns = calloc(rows_per_process[rank] * matrix_size, sizeof(float));
 
     
     // ------------------------------------------------ //
@@ -141,18 +135,13 @@ int main(int argc, char *argv[]) {
     for(int i = 0; i < iterations; i++){
 
         if (rank == 0) {
-            initializeSymmetricMatrix(M, matrix_size);
-            for(int i = 0; i < matrix_size; i++) {
-                for(int j = 0; j < matrix_size; j++) {
-                    M_flat[i * matrix_size + j] = M[i][j];
-                }
-            }
+            initializeSymmetricMatrix(&M);
         }
 
         //printing the matrix
         if(rank == 0) {
             printf("The original matrix is:\n");
-            printMatrix(M, matrix_size);
+            printMatrix(&M);
         }
         
         MPI_Barrier(MPI_COMM_WORLD);
@@ -160,24 +149,24 @@ int main(int argc, char *argv[]) {
         double start_time = MPI_Wtime();
 
 
-        MPI_Scatterv(M_flat, rows_elements_per_process, rows_scatter_displs, MPI_FLOAT, local_rows, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+        MPI_Scatterv(M.data, rows_elements_per_process, rows_scatter_displs, MPI_FLOAT, local_rows, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
         
         // ---
         // Method 1 -> MPI_Type_vector + Scatter
         // ---
         // Scattering around rows
-        //MPI_Scatter(M_flat, 1, column_type, local_columns, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+        //MPI_Scatter(M.data, 1, column_type, local_columns, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
 
         // ---
         // Method 2 -> MPI_Type_create_subarray + Scatter
         // ---
-        //MPI_Scatter(M_flat, 1, column_type, local_columns, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+        //MPI_Scatter(M.data, 1, column_type, local_columns, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
 
         // ---
         // Method 3 -> vector of MPI_Type_create_subarray + Scatter
         // ---
         // for (int i = 0; i < size; i++) { 
-        //     MPI_Scatter(M_flat, 1, column_types[i], local_columns, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD); 
+        //     MPI_Scatter(M.data, 1, column_types[i], local_columns, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD); 
         // }
 
 
@@ -339,14 +328,9 @@ int main(int argc, char *argv[]) {
     free(local_columns);
 
     if(rank == 0) {
-        for (int i = 0; i < matrix_size; i++) {
-            free(M[i]);
-        }
-        free(M_flat);
+        freeMatrix(&M);
     }
 
-    free(M);
-
     // ---
     // METHOD 1 -> MPI_Type_vector + Scatter
     // ---
@@ -367,28 +351,3 @@ int main(int argc, char *argv[]) {
     MPI_Finalize();
     return 0;
 }
-
-
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-// %%%%%% FUNCTIONS DEFINITION %%%%%% //
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-
-void initializeSymmetricMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            float x = (float)rand() / RAND_MAX * 10.0f;
-            matrix[i][j] = x;
-            matrix[j][i] = x;
-            // matrix[i][j] = (float)rand() / RAND_MAX * 10.0f;
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include "transpose.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (option: -path scalar|sse|avx2|avx512).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the forced path, if any, from the options
+    const char *path_name = NULL;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-path") == 0 && a + 1 < argc) {
+            path_name = argv[++a];
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Choosing the kernel from the features of the CPU the program is running on
+    const SymCheckPath *path = selectSymCheckPath(path_name);
+    if (path == NULL) {
+        printf("The path %s is unknown or not supported by this CPU.\n", path_name);
+        return 1;
+    }
+
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        //Initializing the symmetric matrix
+        initializeSymmetricMatrix(&M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking matrix symmetry with the chosen kernel
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+
+        int isSymmetric = path->checkSym(&M);
+
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        // The result has to be used, otherwise with -O1 and above
+        // the check is removed as dead code
+        if (isSymmetric==1) {
+            printf("");
+        }else{
+            printf("The matrix is not symmetric!");
+        }
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
+    }
+
+    double avg_time = total_time / total_iterations;
+    printf("Matrix size: %d x %d. Kernel path: %s. Average time taken: %.3fms\n", rows, cols, path->description, avg_time / 1e-3);
+
+    // printf("Original Matrix:\n");
+    // printMatrix(&M);
+
+    //Freeing memory
+    freeMatrix(&M);
+
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef _WIN32
 #include <windows.h>
 #else
@@ -7,18 +8,26 @@
 #endif
 #include <time.h>
 #include <omp.h>
+#include "transpose.h"
+#include "sym_tiles.h"
 
+// Side (in elements) of the tiles of the early exit check: the flag is read once per tile, i.e. every
+// 32*32 comparisons, which is nothing next to the comparisons themselves
+#define CHECK_TILE 32
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values and makes it symmetric
-void initializeSymmetricMatrix(float **matrix, int n);
 //checks if the matrix is symmetric
-int checkSym(float **matrix, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
+int checkSym(const Matrix *matrix);
+//checks if the matrix is symmetric, every thread stopping at its next tile as soon as one of them finds an asymmetry
+int checkSymEarlyExit(const Matrix *matrix);
+//returns 1 if the rows x cols block at (i1, j1) equals the transpose of its mirror at (j1, i1), one element at a time
+int symmetricBlockScalar(const Matrix *matrix, const void *data, int i1, int j1, int rows, int cols);
+//returns the average time (in seconds) of the check, on a symmetric matrix or, if asymmetric_row is not
+//negative, on one whose only asymmetric pair is (asymmetric_row, asymmetric_row + 1)
+double averageCheckTime(int (*check)(const Matrix *matrix), Matrix *M, int asymmetric_row, int total_iterations);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -27,25 +36,38 @@ void printMatrix(float **matrix, int n);
 
 int main(int argc, char *argv[]) {
     //Checking the number of arguments
-    if (argc != 2) {
-        printf("Please add a matrix size as an argument.\n");
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (option: -asymmetric <row>).\n");
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
+    //Reading the row of the asymmetric pair, if any, from the options (the matrix is symmetric otherwise)
+    int asymmetric_row = -1;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-asymmetric") == 0 && a + 1 < argc) {
+            asymmetric_row = atoi(argv[++a]);
+            if (asymmetric_row < 0 || asymmetric_row + 1 >= rows || rows != cols) {
+                printf("The asymmetric row must be between 0 and %d, in a square matrix.\n", rows - 2);
+                return 1;
+            }
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
 
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
     }
 
     //Setting the number of threads
@@ -54,53 +76,20 @@ int main(int argc, char *argv[]) {
 
     //Set the number of iterations to get a better average time
     int total_iterations = 50;
-    double total_time = 0.0;
-
-    for(int i = 0; i < total_iterations; i++) {
-        //printf("Iteration %d \n", i);
-        //Initializing the symmetric matrix
-        initializeSymmetricMatrix(M, matrix_size); 
-
-        // Structure to store the time
-        struct timeval start, end;
-        long seconds, microseconds;
-        double time_taken;
-
-        //Checking matrix symmetry
-        #ifdef _WIN32
-            mingw_gettimeofday(&start, NULL);
-        #else
-            gettimeofday(&start, NULL);
-        #endif
-        
-        int isSymmetric = checkSym(M, matrix_size);
-        
-        #ifdef _WIN32
-            mingw_gettimeofday(&end, NULL);
-        #else
-            gettimeofday(&end, NULL);
-        #endif
+    double avg_time = averageCheckTime(checkSym, &M, asymmetric_row, total_iterations);
+    double early_exit_time = averageCheckTime(checkSymEarlyExit, &M, asymmetric_row, total_iterations);
 
-        //printf("Matrix is %s\n", isSymmetric ? "symmetric" : "not symmetric");
-
-        //Time elapsed calculation
-        seconds = end.tv_sec - start.tv_sec;
-        microseconds = end.tv_usec - start.tv_usec;
-        time_taken = seconds + microseconds / 1e6;
-        total_time += time_taken;
+    if (asymmetric_row < 0) {
+        printf("Matrix size: %d x %d. Threads number: %d. Average time taken: %.3fms. Early exit: %.3fms. Speedup: %.2fx\n", rows, cols, number_of_threads, avg_time / 1e-3, early_exit_time / 1e-3, avg_time / early_exit_time);
+    } else {
+        printf("Matrix size: %d x %d. Threads number: %d. Asymmetric row: %d. Average time taken: %.3fms. Early exit: %.3fms. Speedup: %.2fx\n", rows, cols, number_of_threads, asymmetric_row, avg_time / 1e-3, early_exit_time / 1e-3, avg_time / early_exit_time);
     }
-    
-    double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Threads number: %d. Average time taken: %.3fms\n", matrix_size, matrix_size, number_of_threads, avg_time / 1e-3);
 
     // printf("Original Matrix:\n");
-    // printMatrix(M, matrix_size);
+    // printMatrix(&M);
 
     //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-    }
-    free(M);
+    freeMatrix(&M);
     
     return 0;
 }
@@ -110,13 +99,17 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-int checkSym(float **matrix, int n) {
+int checkSym(const Matrix *matrix) {
     int isSymmetric = 1;
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
     #pragma omp parallel for reduction(&&:isSymmetric) // schedule(static, 8)
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < matrix->rows; i++) {
         // #pragma omp simd
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != matrix[j][i]) {
+        for (int j = 0; j < matrix->cols; j++) {
+            if (MAT(matrix, i, j) != MAT(matrix, j, i)) {
                 #pragma omp atomic write
                 isSymmetric = 0;
             }
@@ -125,21 +118,69 @@ int checkSym(float **matrix, int n) {
     return isSymmetric;
 }
 
-void initializeSymmetricMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j <= i; j++) {
-            float value = (float)rand();
-            matrix[i][j] = value;
-            matrix[j][i] = value;
+int checkSymEarlyExit(const Matrix *matrix) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+    // One block per tile: the whole tile is compared in a single loop nest
+    return checkMirrorBlocks(matrix, matrix->rows, CHECK_TILE, CHECK_TILE, symmetricBlockScalar, NULL);
+}
+
+int symmetricBlockScalar(const Matrix *matrix, const void *data, int i1, int j1, int rows, int cols) {
+    (void)data;
+    // No branch inside the block: the differences are accumulated, so the loop over j vectorizes
+    int differ = 0;
+    for (int i = i1; i < i1 + rows; i++) {
+        for (int j = (j1 > i) ? j1 : i + 1; j < j1 + cols; j++) {
+            differ |= MAT(matrix, i, j) != MAT(matrix, j, i);
         }
     }
+    return !differ;
 }
 
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
+double averageCheckTime(int (*check)(const Matrix *matrix), Matrix *M, int asymmetric_row, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        //Initializing the symmetric matrix, then breaking its symmetry in the row asked
+        initializeSymmetricMatrix(M);
+        if (asymmetric_row >= 0) {
+            MAT(M, asymmetric_row, asymmetric_row + 1) = -MAT(M, asymmetric_row + 1, asymmetric_row) - 1.0f;
+        }
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking matrix symmetry
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+
+        int isSymmetric = check(M);
+
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        // The result has to be used, otherwise the check could be dropped as dead code
+        int expected = asymmetric_row < 0 && M->rows == M->cols;
+        if (isSymmetric != expected) {
+            printf("The check is wrong: the matrix is %s!\n", expected ? "symmetric" : "not symmetric");
         }
-        printf("\n");
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
     }
-}
\ No newline at end of file
+
+    return total_time / total_iterations;
+}
@@ -7,18 +7,15 @@
 #endif
 #include <time.h>
 #include <omp.h>
+#include "transpose.h"
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values and makes it symmetric
-void initializeSymmetricMatrix(float **matrix, int n);
 //checks if the matrix is symmetric
-int checkSym(float **matrix, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
+int checkSym(const Matrix *matrix);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -32,20 +29,18 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
-
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
     }
 
     // For my windows machine 
@@ -62,7 +57,7 @@ int main(int argc, char *argv[]) {
 
         for(int i = 0; i < total_iterations; i++) {
             // Initializing the completely casual matrix
-            initializeSymmetricMatrix(M, matrix_size);
+            initializeSymmetricMatrix(&M);
 
             // Structure to store the time
             struct timeval start, end;
@@ -76,7 +71,7 @@ int main(int argc, char *argv[]) {
                 gettimeofday(&start, NULL);
             #endif
 
-            int isSymmetric = checkSym(M, matrix_size);
+            int isSymmetric = checkSym(&M);
             
             #ifdef _WIN32
                 mingw_gettimeofday(&end, NULL);
@@ -92,17 +87,14 @@ int main(int argc, char *argv[]) {
         }
 
         double avg_time = total_time / total_iterations;
-        printf("Matrix size: %d x %d. Threads number: %d. Average time taken: %.3fms\n", matrix_size, matrix_size, n, avg_time / 1e-3);
+        printf("Matrix size: %d x %d. Threads number: %d. Average time taken: %.3fms\n", rows, cols, n, avg_time / 1e-3);
     }
 
     // printf("Original Matrix:\n");
-    // printMatrix(M, matrix_size);
+    // printMatrix(&M);
 
     //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-    }
-    free(M);
+    freeMatrix(&M);
     
     return 0;
 }
@@ -112,13 +104,17 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-int checkSym(float **matrix, int n) {
+int checkSym(const Matrix *matrix) {
     int isSymmetric = 1;
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
     #pragma omp parallel for reduction(&:isSymmetric) schedule(static, 8)
-    for (int i = 0; i < n; i++) {
+    for (int i = 0; i < matrix->rows; i++) {
         // #pragma omp simd
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != matrix[j][i]) {
+        for (int j = 0; j < matrix->cols; j++) {
+            if (MAT(matrix, i, j) != MAT(matrix, j, i)) {
                 #pragma omp atomic write
                 isSymmetric = 0;
             }
@@ -126,22 +122,3 @@ int checkSym(float **matrix, int n) {
     }
     return isSymmetric;
 }
-
-void initializeSymmetricMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j <= i; j++) {
-            float value = (float)rand();
-            matrix[i][j] = value;
-            matrix[j][i] = value;
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
\ No newline at end of file
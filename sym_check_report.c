@@ -0,0 +1,161 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <omp.h>
+#include "transpose.h"
+#include "sym_tolerance.h"
+#include "sym_report.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns the average time (in seconds) of the report keeping max_positions positions, or of the exact check
+//of sym_tolerance.h if report is NULL, on symmetric matrices with pairs asymmetric pairs planted (if not 0).
+//The report of the last matrix is left in report
+double averageReportTime(Matrix *M, SymReport *report, int max_positions, int pairs, int total_iterations);
+//prints the report of the asymmetries
+void printSymReport(const SymReport *report);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -positions <count>, -asymmetric <pairs>).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+    if (rows != cols) {
+        printf("The report is only defined for square matrices.\n");
+        return 1;
+    }
+
+    //Reading the number of positions to report (8 by default) and of asymmetric pairs to plant (16 by default)
+    int max_positions = 8;
+    int pairs = 16;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-positions") == 0 && a + 1 < argc) {
+            max_positions = atoi(argv[++a]);
+            if (max_positions < 0 || max_positions > SYM_REPORT_MAX_POSITIONS) {
+                printf("The number of positions must be between 0 and %d.\n", SYM_REPORT_MAX_POSITIONS);
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-asymmetric") == 0 && a + 1 < argc) {
+            pairs = atoi(argv[++a]);
+            if (pairs < 0) {
+                printf("The number of asymmetric pairs cannot be negative.\n");
+                return 1;
+            }
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
+    }
+
+    //Setting the number of threads
+    int number_of_threads = 8;
+    omp_set_num_threads(number_of_threads);
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    SymReport report;
+
+    //Both on symmetric matrices first, so that the check scans the whole upper triangle as the report always does
+    double check_time = averageReportTime(&M, NULL, max_positions, 0, total_iterations);
+    double report_time = averageReportTime(&M, &report, max_positions, 0, total_iterations);
+    printf("Matrix size: %d x %d. Threads number: %d. Exact check: %.3fms. Report: %.3fms. Cost of the report: %.2fx\n", rows, cols, number_of_threads, check_time / 1e-3, report_time / 1e-3, report_time / check_time);
+
+    //Then the report of matrices with asymmetric pairs planted
+    if (pairs > 0) {
+        report_time = averageReportTime(&M, &report, max_positions, pairs, total_iterations);
+        printf("Matrix size: %d x %d. Asymmetric pairs planted: %d. Report: %.3fms\n", rows, cols, pairs, report_time / 1e-3);
+        printSymReport(&report);
+    }
+
+    //Freeing memory
+    freeMatrix(&M);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageReportTime(Matrix *M, SymReport *report, int max_positions, int pairs, int total_iterations) {
+    double total_time = 0.0;
+    // the same matrices for the check and the report
+    srand(1);
+
+    for(int i = 0; i < total_iterations; i++) {
+        //Initializing the symmetric matrix, then making some of its pairs asymmetric
+        initializeSymmetricMatrix(M);
+        if (pairs > 0) {
+            plantAsymmetries(M, pairs);
+        }
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking matrix symmetry, or reporting what is wrong with it
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+
+        if (report != NULL) {
+            reportAsymmetry(M, max_positions, report);
+        } else {
+            checkSymTolerance(M, NULL);
+        }
+
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
+    }
+
+    return total_time / total_iterations;
+}
+
+void printSymReport(const SymReport *report) {
+    printf("Asymmetric pairs: %lld of %lld. Max deviation: %g. RMS deviation: %g\n", report->asymmetric, report->pairs, report->max_deviation, symReportRms(report));
+    for (int p = 0; p < report->positions; p++) {
+        printf("    (%d, %d)\n", report->position_rows[p], report->position_cols[p]);
+    }
+}
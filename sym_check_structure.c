@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <omp.h>
+#include "transpose.h"
+#include "sym_structure.h"
+
+// One engine checking the structures of sym_structure.h
+typedef struct {
+    const char *name;
+    int (*check)(const Matrix *matrix, MatrixStructure structure);
+} StructureEngine;
+
+static const StructureEngine engines[] = {
+    {"sequential", checkStructureScalar},
+    {"SIMD", checkStructureAVX2},
+    {"OpenMP", checkStructureOpenMP},
+};
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns the average time (in seconds) of the engine checking matrices with the structure
+double averageStructureTime(const StructureEngine *engine, MatrixStructure structure, Matrix *M, int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (option: -structure symmetric|skew|hermitian).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+    if (rows != cols) {
+        printf("The structures are only defined for square matrices.\n");
+        return 1;
+    }
+
+    //Reading the structure to check (skew-symmetric by default)
+    MatrixStructure structure = STRUCTURE_SKEW_SYMMETRIC;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-structure") == 0 && a + 1 < argc) {
+            a++;
+            if (strcmp(argv[a], "symmetric") == 0) {
+                structure = STRUCTURE_SYMMETRIC;
+            } else if (strcmp(argv[a], "skew") == 0) {
+                structure = STRUCTURE_SKEW_SYMMETRIC;
+            } else if (strcmp(argv[a], "hermitian") == 0) {
+                structure = STRUCTURE_HERMITIAN;
+            } else {
+                printf("Unknown structure %s (symmetric, skew or hermitian).\n", argv[a]);
+                return 1;
+            }
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Allocating memory for the matrix M (one contiguous aligned block, two floats per complex element)
+    Matrix M;
+    if (!allocMatrix(&M, rows, (structure == STRUCTURE_HERMITIAN) ? 2 * cols : cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
+    }
+
+    //Setting the number of threads of the OpenMP engine
+    int number_of_threads = 8;
+    omp_set_num_threads(number_of_threads);
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double times[3];
+    for (int e = 0; e < 3; e++) {
+        times[e] = averageStructureTime(&engines[e], structure, &M, total_iterations);
+    }
+
+    printf("Matrix size: %d x %d. Structure: %s. Sequential: %.3fms. SIMD: %.3fms. OpenMP (%d threads): %.3fms\n", rows, cols, structureName(structure), times[0] / 1e-3, times[1] / 1e-3, number_of_threads, times[2] / 1e-3);
+
+    //Freeing memory
+    freeMatrix(&M);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageStructureTime(const StructureEngine *engine, MatrixStructure structure, Matrix *M, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        //Initializing the matrix with the structure
+        initializeStructuredMatrix(M, structure);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking the structure of the matrix
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+
+        int has_structure = engine->check(M, structure);
+
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        // The result is used, so that the check is not removed as dead code
+        if (!has_structure) {
+            printf("The %s engine finds the matrix not %s!\n", engine->name, structureName(structure));
+        }
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
+    }
+
+    return total_time / total_iterations;
+}
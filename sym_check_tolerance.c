@@ -0,0 +1,215 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <math.h>
+#include <omp.h>
+#include "transpose.h"
+#include "sym_tolerance.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//moves every element below the diagonal up by 0 to noise representable floats, as the rounding of a
+//floating-point pipeline would (the elements of initializeSymmetricMatrix are never negative)
+void perturbMatrix(Matrix *matrix, int noise);
+//returns the average time (in seconds) of checkSymTolerance with the tolerance (NULL for the exact check)
+//on a symmetric matrix perturbed by noise (if not 0), and in is_symmetric the answer of the last check
+double averageToleranceTime(Matrix *M, const SymTolerance *tolerance, int noise, int total_iterations, int *is_symmetric);
+//checks checkSymTolerance on pairs whose answer is known (opposite signs, infinities), in full and partial
+//blocks, and returns the number of wrong answers (printing them)
+int checkToleranceEdgeCases(void);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -abs <epsilon>, -rel <epsilon>, -ulps <distance>, -noise <ulps>).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the tolerance (4 ULPs by default) and the noise added below the diagonal (2 ULPs by default)
+    SymTolerance tolerance = {0.0f, 0.0f, 4};
+    int noise = 2;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-abs") == 0 && a + 1 < argc) {
+            tolerance.absolute = (float)atof(argv[++a]);
+        } else if (strcmp(argv[a], "-rel") == 0 && a + 1 < argc) {
+            tolerance.relative = (float)atof(argv[++a]);
+        } else if (strcmp(argv[a], "-ulps") == 0 && a + 1 < argc) {
+            tolerance.ulps = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-noise") == 0 && a + 1 < argc) {
+            noise = atoi(argv[++a]);
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+    if (tolerance.absolute < 0.0f || tolerance.relative < 0.0f || tolerance.ulps < 0 || noise < 0) {
+        printf("The tolerances and the noise cannot be negative.\n");
+        return 1;
+    }
+
+    //The pairs with a known answer first: the timings mean nothing if the check is wrong
+    if (checkToleranceEdgeCases() != 0) {
+        return 1;
+    }
+
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
+    }
+
+    //Setting the number of threads
+    int number_of_threads = 8;
+    omp_set_num_threads(number_of_threads);
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    int exact_symmetric, tolerance_symmetric;
+
+    //Both checks on symmetric matrices first, so that both scan the whole upper triangle: the throughputs compare
+    double exact_time = averageToleranceTime(&M, NULL, 0, total_iterations, &exact_symmetric);
+    double tolerance_time = averageToleranceTime(&M, &tolerance, 0, total_iterations, &tolerance_symmetric);
+    printf("Matrix size: %d x %d. Threads number: %d. Tolerance: abs %g, rel %g, %d ulps. Exact check: %.3fms. Tolerance check: %.3fms. Throughput of the exact check: %.0f%%\n", rows, cols, number_of_threads, tolerance.absolute, tolerance.relative, tolerance.ulps, exact_time / 1e-3, tolerance_time / 1e-3, 100.0 * exact_time / tolerance_time);
+
+    //Then on matrices perturbed by the noise, which only the tolerance check should accept
+    if (noise > 0) {
+        exact_time = averageToleranceTime(&M, NULL, noise, total_iterations, &exact_symmetric);
+        tolerance_time = averageToleranceTime(&M, &tolerance, noise, total_iterations, &tolerance_symmetric);
+        printf("Matrix size: %d x %d. Noise: %d ulps. Exact check: %s (%.3fms). Tolerance check: %s (%.3fms)\n", rows, cols, noise, exact_symmetric ? "symmetric" : "not symmetric", exact_time / 1e-3, tolerance_symmetric ? "symmetric" : "not symmetric", tolerance_time / 1e-3);
+    }
+
+    //Freeing memory
+    freeMatrix(&M);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+void perturbMatrix(Matrix *matrix, int noise) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < i && j < matrix->cols; j++) {
+            // a non-negative float moves up by one representable float when its bits grow by one
+            unsigned int bits;
+            memcpy(&bits, &MAT(matrix, i, j), sizeof(bits));
+            bits += (unsigned int)(rand() % (noise + 1));
+            memcpy(&MAT(matrix, i, j), &bits, sizeof(bits));
+        }
+    }
+}
+
+double averageToleranceTime(Matrix *M, const SymTolerance *tolerance, int noise, int total_iterations, int *is_symmetric) {
+    double total_time = 0.0;
+    // the same matrices for both checks
+    srand(1);
+
+    for(int i = 0; i < total_iterations; i++) {
+        //Initializing the symmetric matrix, then perturbing it below the diagonal
+        initializeSymmetricMatrix(M);
+        if (noise > 0) {
+            perturbMatrix(M, noise);
+        }
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking matrix symmetry
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+
+        *is_symmetric = checkSymTolerance(M, tolerance);
+
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
+    }
+
+    return total_time / total_iterations;
+}
+
+int checkToleranceEdgeCases(void) {
+    // a_12 and a_21, the tolerance and whether the pair is within it
+    typedef struct {
+        const char *name;
+        float a;
+        float b;
+        SymTolerance tolerance;
+        int expected;
+    } EdgeCase;
+
+    // the float just below -2 in magnitude, whose ordered key is 2^31 away from the key of 2
+    unsigned int bits = 0xBFFFFFFFu;
+    float below_minus_two;
+    memcpy(&below_minus_two, &bits, sizeof(below_minus_two));
+
+    const EdgeCase cases[] = {
+        {"2 vs -1.9999999, 1 ulp", 2.0f, below_minus_two, {0.0f, 0.0f, 1}, 0},
+        {"1 vs -1, 4 ulps", 1.0f, -1.0f, {0.0f, 0.0f, 4}, 0},
+        {"1 vs the next float, 1 ulp", 1.0f, nextafterf(1.0f, 2.0f), {0.0f, 0.0f, 1}, 1},
+        {"+0 vs -0, exact", 0.0f, -0.0f, {0.0f, 0.0f, 0}, 1},
+        {"inf vs 1, rel 1e-3", INFINITY, 1.0f, {0.0f, 1e-3f, 0}, 0},
+        {"inf vs -inf, rel 1e-3", INFINITY, -INFINITY, {0.0f, 1e-3f, 0}, 0},
+        {"inf vs -inf, abs 1", INFINITY, -INFINITY, {1.0f, 0.0f, 0}, 0},
+        {"inf vs inf, rel 1e-3", INFINITY, INFINITY, {0.0f, 1e-3f, 0}, 1},
+    };
+    // 16 x 16 has only full blocks, 9 x 9 partial ones at the edge
+    const int sides[] = {16, 9};
+
+    int wrong = 0;
+    for (int s = 0; s < 2; s++) {
+        Matrix M;
+        if (!allocMatrix(&M, sides[s], sides[s])) {
+            printf("Unable to allocate the matrix.\n");
+            return 1;
+        }
+        for (int c = 0; c < (int)(sizeof(cases) / sizeof(cases[0])); c++) {
+            memset(M.data, 0, (size_t)M.rows * M.ld * sizeof(float));
+            MAT(&M, 1, 2) = cases[c].a;
+            MAT(&M, 2, 1) = cases[c].b;
+            if (checkSymTolerance(&M, &cases[c].tolerance) != cases[c].expected) {
+                printf("Wrong answer on %d x %d: %s should be %s.\n", sides[s], sides[s], cases[c].name, cases[c].expected ? "symmetric" : "not symmetric");
+                wrong++;
+            }
+        }
+        freeMatrix(&M);
+    }
+    return wrong;
+}
@@ -0,0 +1,172 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "matrix.h"
+#include "typed_kernels.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// One element type with the functions that work on its matrices (rows x cols, no padding)
+typedef struct {
+    const char *name;
+    const char *description;
+    size_t size;
+    void (*initializeSymmetric)(void *matrix, int rows, int cols);
+    int (*checkSym)(const void *matrix, int rows, int cols);
+} ElementType;
+
+// Defines, for one element type, the random symmetric initialization and the call of its symmetry check
+#define DEFINE_ELEMENT_TYPE_FUNCTIONS(NAME, TYPE, RANDOM) \
+void initializeSymmetricMatrix##NAME(void *matrix, int rows, int cols) { \
+    TYPE *m = (TYPE *)matrix; \
+    for (int i = 0; i < rows; i++) { \
+        for (int j = 0; j < cols; j++) { \
+            /* the lower triangle mirrors the rows already filled */ \
+            m[(size_t)i * cols + j] = (j < i && i < cols) ? m[(size_t)j * cols + i] : RANDOM; \
+        } \
+    } \
+} \
+int checkSymmetry##NAME(const void *matrix, int rows, int cols) { \
+    return checkSym##NAME((const TYPE *)matrix, cols, rows, cols); \
+}
+
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Float, float, (float)rand())
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Double, double, (double)rand())
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Complex, complex_float, (float)rand() + (float)rand() * I)
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Int16, int16_t, (int16_t)rand())
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Int8, int8_t, (int8_t)rand())
+
+static const ElementType element_types[] = {
+    {"float", "float (8x8 AVX2 blocks)", sizeof(float), initializeSymmetricMatrixFloat, checkSymmetryFloat},
+    {"double", "double (4x4 AVX2 blocks)", sizeof(double), initializeSymmetricMatrixDouble, checkSymmetryDouble},
+    {"complex", "complex float (4x4 AVX2 blocks)", sizeof(complex_float), initializeSymmetricMatrixComplex, checkSymmetryComplex},
+    {"int16", "int16 (16x16 AVX2 blocks)", sizeof(int16_t), initializeSymmetricMatrixInt16, checkSymmetryInt16},
+    {"int8", "int8 (16x16 SSE2 blocks)", sizeof(int8_t), initializeSymmetricMatrixInt8, checkSymmetryInt8},
+};
+
+//returns the average time (in seconds) of the symmetry check of a rows x cols matrix of the given type
+double averageCheckTime(const ElementType *type, void *M, int rows, int cols, int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (option: -type float|double|complex|int16|int8).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the element type, if any, from the options (all of them one after the other otherwise)
+    const char *type_name = NULL;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-type") == 0 && a + 1 < argc) {
+            type_name = argv[++a];
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    int found = 0;
+
+    for (int t = 0; t < (int)(sizeof(element_types) / sizeof(element_types[0])); t++) {
+        const ElementType *type = &element_types[t];
+        if (type_name != NULL && strcmp(type_name, type->name) != 0) {
+            continue;
+        }
+        found = 1;
+
+        //Allocating memory for the matrix M (one contiguous aligned block)
+        void *M = allocAligned((size_t)rows * cols * type->size);
+        if (M == NULL) {
+            printf("Unable to allocate the matrix.\n");
+            return 1;
+        }
+
+        double avg_time = averageCheckTime(type, M, rows, cols, total_iterations);
+        printf("Matrix size: %d x %d. Element type: %s. Average time taken: %.3fms\n", rows, cols, type->description, avg_time / 1e-3);
+
+        //Freeing memory
+        freeAligned(M);
+    }
+
+    if (!found) {
+        printf("The element type %s is unknown.\n", type_name);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageCheckTime(const ElementType *type, void *M, int rows, int cols, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        //Initializing the symmetric matrix
+        type->initializeSymmetric(M, rows, cols);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking matrix symmetry
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+
+        int isSymmetric = type->checkSym(M, rows, cols);
+
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        // The result has to be used, otherwise with -O1 and above
+        // the check is removed as dead code
+        if (isSymmetric==1) {
+            printf("");
+        }else{
+            printf("The matrix is not symmetric!");
+        }
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
+    }
+
+    return total_time / total_iterations;
+}
@@ -6,18 +6,15 @@
 #include <sys/time.h>
 #endif
 #include <time.h>
+#include "transpose.h"
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values and makes it symmetric
-void initializeSymmetricMatrix(float **matrix, int n);
 //checks if the matrix is symmetric (CHANGE THE LEVEL OF UNROLLIN IN THIS FUNCTION DEFINITION)
-int checkSym(float **matrix, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
+int checkSym(const Matrix *matrix);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -31,20 +28,18 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
-
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
     }
 
     //Set the number of iterations to get a better average time
@@ -54,7 +49,7 @@ int main(int argc, char *argv[]) {
     for(int i = 0; i < total_iterations; i++) {
         //printf("Iteration %d \n", i);
         //Initializing the symmetric matrix
-        initializeSymmetricMatrix(M, matrix_size); 
+        initializeSymmetricMatrix(&M); 
 
         // Structure to store the time
         struct timeval start, end;
@@ -68,7 +63,7 @@ int main(int argc, char *argv[]) {
             gettimeofday(&start, NULL);
         #endif
         
-        int isSymmetric = checkSym(M, matrix_size);
+        int isSymmetric = checkSym(&M);
         
         #ifdef _WIN32
             mingw_gettimeofday(&end, NULL);
@@ -95,16 +90,13 @@ int main(int argc, char *argv[]) {
     }
     
     double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", matrix_size, matrix_size, avg_time / 1e-3);
+    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", rows, cols, avg_time / 1e-3);
 
     // printf("Original Matrix:\n");
-    // printMatrix(M, matrix_size);
+    // printMatrix(&M);
 
     //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-    }
-    free(M);
+    freeMatrix(&M);
     
     return 0;
 }
@@ -114,47 +106,39 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-int checkSym(float **matrix, int n) {
+int checkSym(const Matrix *matrix) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
     // !!!!! CRITICAL IN ORDER TO EXECUTE DIFFERENT BLOCK SIZES -> Comment or Uncomment the lines below to change the block size !!!!!
     int blockSize = 2;
     // int blockSize = 4;
     // int blockSize = 8;
 
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < i - blockSize + 1; j += blockSize) {
+    for (int i = 0; i < matrix->rows; i++) {
+        int j;
+        for (j = 0; j < i - blockSize + 1; j += blockSize) {
             if (
-                matrix[i][j] != matrix[j][i]
-                || matrix[i][j + 1] != matrix[j + 1][i]
-                // || matrix[i][j + 2] != matrix[j + 2][i]
-                // || matrix[i][j + 3] != matrix[j + 3][i]
-                // || matrix[i][j + 4] != matrix[j + 4][i]
-                // || matrix[i][j + 5] != matrix[j + 5][i]
-                // || matrix[i][j + 6] != matrix[j + 6][i]
-                // || matrix[i][j + 7] != matrix[j + 7][i]
+                MAT(matrix, i, j) != MAT(matrix, j, i)
+                || MAT(matrix, i, j + 1) != MAT(matrix, j + 1, i)
+                // || MAT(matrix, i, j + 2) != MAT(matrix, j + 2, i)
+                // || MAT(matrix, i, j + 3) != MAT(matrix, j + 3, i)
+                // || MAT(matrix, i, j + 4) != MAT(matrix, j + 4, i)
+                // || MAT(matrix, i, j + 5) != MAT(matrix, j + 5, i)
+                // || MAT(matrix, i, j + 6) != MAT(matrix, j + 6, i)
+                // || MAT(matrix, i, j + 7) != MAT(matrix, j + 7, i)
                 ) 
             {
                 return 0;
             }
         }
-    }
-    return 1;
-}
-
-void initializeSymmetricMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j <= i; j++) {
-            float value = (float)rand();
-            matrix[i][j] = value;
-            matrix[j][i] = value;
+        // Elements left out of the last block before the diagonal
+        for (; j < i; j++) {
+            if (MAT(matrix, i, j) != MAT(matrix, j, i)) {
+                return 0;
+            }
         }
     }
+    return 1;
 }
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
\ No newline at end of file
@@ -0,0 +1,141 @@
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "transpose.h"
+
+#ifndef __AVX512F__
+#error "sym_check_vectorization_16.c uses AVX-512 intrinsics: compile it with -mavx512f"
+#endif
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//checks if the matrix is symmetric
+int checkSym(const Matrix *matrix);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc != 2) {
+        printf("Please add a matrix size as an argument.\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        //printf("Iteration %d \n", i);
+        //Initializing the symmetric matrix
+        initializeSymmetricMatrix(&M); 
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        //Checking matrix symmetry
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        
+        int isSymmetric = checkSym(&M);
+        
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        // I had to add this apparently usless print because 
+        // with flags such as -O1 -O2 and -O3, if the result 
+        // (in this case "is Symmetric") is not used, the 
+        // execution of the function is classified as death 
+        // code and so it is not executed. 
+        if (isSymmetric==1) {
+            printf("");
+        }else{
+            printf("The matrix is not symmetric!");
+        }
+
+        //Time elapsed calculation
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds / 1e6;
+        total_time += time_taken;
+    }
+    
+    double avg_time = total_time / total_iterations;
+    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", rows, cols, avg_time / 1e-3);
+
+    // printf("Original Matrix:\n");
+    // printMatrix(&M);
+
+    //Freeing memory
+    freeMatrix(&M);
+    
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int checkSym(const Matrix *matrix) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+
+    // Distance (in floats) of 16 consecutive elements of a column from the first one: a single
+    // gather instruction replaces the 16 scalar loads of _mm256_set_ps/_mm512_set_ps
+    __m512i column_offsets = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(matrix->ld));
+
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < i; j += 16) { // Process 16 elements at a time
+            // The last chunk before the diagonal is masked, so no scalar remainder is needed
+            __mmask16 mask = (i - j < 16) ? (__mmask16)((1u << (i - j)) - 1) : (__mmask16)0xFFFF;
+
+            // Load 16 elements from row i and column j
+            __m512 row_vec = _mm512_maskz_loadu_ps(mask, &MAT(matrix, i, j));
+
+            // Gather 16 elements from column i and row j
+            __m512 col_vec = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, column_offsets, &MAT(matrix, j, i), sizeof(float));
+
+            // Compare row_vec and col_vec directly into a mask register: any bit set is a mismatch
+            if (_mm512_mask_cmp_ps_mask(mask, row_vec, col_vec, _CMP_NEQ_OQ) != 0) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
@@ -7,19 +7,15 @@
 #endif
 #include <time.h>
 #include <immintrin.h>
+#include "transpose.h"
+#include "simd_kernels.h"
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values and makes it symmetric
-void initializeSymmetricMatrix(float **matrix, int n);
 //checks if the matrix is symmetric
-int checkSym(float **matrix, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
-//checks if the matrix is stored in row-major order
-int isRowMajor(float **matrix, int n);
+int checkSym(const Matrix *matrix);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -33,20 +29,18 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
-
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Allocating memory for the matrix M (one contiguous aligned block)
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
     }
 
     //Set the number of iterations to get a better average time
@@ -56,13 +50,7 @@ int main(int argc, char *argv[]) {
     for(int i = 0; i < total_iterations; i++) {
         //printf("Iteration %d \n", i);
         //Initializing the symmetric matrix
-        initializeSymmetricMatrix(M, matrix_size); 
-
-        // Check if the matrix is stored in row-major order
-        if (!isRowMajor(M, matrix_size)) {
-            printf("Matrix is not stored in row-major order.\n");
-            return 1;
-        }
+        initializeSymmetricMatrix(&M); 
 
         // Structure to store the time
         struct timeval start, end;
@@ -76,7 +64,7 @@ int main(int argc, char *argv[]) {
             gettimeofday(&start, NULL);
         #endif
         
-        int isSymmetric = checkSym(M, matrix_size);
+        int isSymmetric = checkSym(&M);
         
         #ifdef _WIN32
             mingw_gettimeofday(&end, NULL);
@@ -103,16 +91,13 @@ int main(int argc, char *argv[]) {
     }
     
     double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", matrix_size, matrix_size, avg_time / 1e-3);
+    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", rows, cols, avg_time / 1e-3);
 
     // printf("Original Matrix:\n");
-    // printMatrix(M, matrix_size);
+    // printMatrix(&M);
 
     //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-    }
-    free(M);
+    freeMatrix(&M);
     
     return 0;
 }
@@ -122,56 +107,31 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-int checkSym(float **matrix, int n) {
-    int isSymmetric = 1;
-    // Assuming matrix is row-major and a power of 2 for simplicity
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < i; j += 8) { // Process 8 elements at a time
-            // Load 8 elements from row i and column j
-            __m256 row_vec = _mm256_loadu_ps(&matrix[i][j]);
-
-            // Load 8 elements from column i and row j
-            __m256 col_vec = _mm256_set_ps(matrix[j + 7][i], matrix[j + 6][i], matrix[j + 5][i], matrix[j + 4][i], matrix[j + 3][i], matrix[j + 2][i], matrix[j + 1][i], matrix[j][i]);
-
-            // Compare row_vec and col_vec
-            __m256 cmp = _mm256_cmp_ps(row_vec, col_vec, _CMP_NEQ_OQ);
-
-            // Move the comparison result to an integer
-            isSymmetric = _mm256_movemask_ps(cmp);
+int checkSym(const Matrix *matrix) {
+    const int blockSize = 8;
+    int n = matrix->rows;
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
 
-            // If any element mismatches, set isSymmetric = 0
-            if (isSymmetric != 0) {
+    // Only the tiles on and above the diagonal are visited: each one is compared with its mirror below it,
+    // both read row by row, and the mirror transposed in registers
+    for (int i = 0; i < n; i += blockSize) {
+        int block_rows = (n - i < blockSize) ? n - i : blockSize;
+        for (int j = i; j < n; j += blockSize) {
+            int block_cols = (n - j < blockSize) ? n - j : blockSize;
+            int symmetric;
+            if (block_rows == blockSize && block_cols == blockSize) {
+                symmetric = symmetricBlocks8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld);
+            } else {
+                // remainder rows and columns at the edge of the matrix
+                symmetric = symmetricBlocksPartial8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld, block_rows, block_cols);
+            }
+            if (!symmetric) {
                 return 0;
             }
         }
     }
     return 1;
 }
-
-void initializeSymmetricMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j <= i; j++) {
-            float value = (float)rand();
-            matrix[i][j] = value;
-            matrix[j][i] = value;
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-int isRowMajor(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        if (&matrix[i][1] != &matrix[i][0] + 1) { //checking whether memory addresses are contiguous
-            return 0;
-        }
-    }
-    return 1;
-}
\ No newline at end of file
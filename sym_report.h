@@ -0,0 +1,237 @@
+#ifndef SYM_REPORT_H
+#define SYM_REPORT_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <immintrin.h>
+#include "matrix.h"
+#include "simd_kernels.h"
+#include "sym_tolerance.h"
+
+// Most positions of asymmetric pairs a report can hold
+#define SYM_REPORT_MAX_POSITIONS 64
+
+// What is wrong with a matrix that is not symmetric, over the pairs (i, j) with i < j of the rows reported:
+// how many pairs differ, the first of them in row-major order, and the largest and the root mean square of
+// |a_ij - a_ji| over all the pairs (the symmetric ones count as 0). The pairs are compared exactly, as
+// checkSym does (_CMP_NEQ_OQ: a NaN is never reported)
+typedef struct {
+    long long pairs;
+    long long asymmetric;
+    double max_deviation;
+    double sum_squares;
+    int positions;
+    int position_rows[SYM_REPORT_MAX_POSITIONS];
+    int position_cols[SYM_REPORT_MAX_POSITIONS];
+} SymReport;
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//adds the asymmetric pair (i, j) to the positions of the report if it is among the first max_positions
+//found so far (the positions are kept in row-major order)
+static inline void recordAsymmetricPair(SymReport *report, int max_positions, int i, int j) {
+    int p = report->positions;
+    if (p == max_positions) {
+        // full: the pair has to come before the last one, which it replaces
+        if (p == 0 || i > report->position_rows[p - 1] || (i == report->position_rows[p - 1] && j > report->position_cols[p - 1])) {
+            return;
+        }
+        p--;
+    } else {
+        report->positions++;
+    }
+    // insertion in order, the pairs after it moving down by one
+    while (p > 0 && (report->position_rows[p - 1] > i || (report->position_rows[p - 1] == i && report->position_cols[p - 1] > j))) {
+        report->position_rows[p] = report->position_rows[p - 1];
+        report->position_cols[p] = report->position_cols[p - 1];
+        p--;
+    }
+    report->position_rows[p] = i;
+    report->position_cols[p] = j;
+}
+
+//adds the report from (of other rows) to the report into, keeping the first max_positions positions of both
+static inline void mergeSymReports(SymReport *into, const SymReport *from, int max_positions) {
+    into->pairs += from->pairs;
+    into->asymmetric += from->asymmetric;
+    into->sum_squares += from->sum_squares;
+    if (from->max_deviation > into->max_deviation) {
+        into->max_deviation = from->max_deviation;
+    }
+    for (int p = 0; p < from->positions; p++) {
+        recordAsymmetricPair(into, max_positions, from->position_rows[p], from->position_cols[p]);
+    }
+}
+
+//returns the root mean square of |a_ij - a_ji| over the pairs of the report
+static inline double symReportRms(const SymReport *report) {
+    if (report->pairs == 0) {
+        return 0.0;
+    }
+    return sqrt(report->sum_squares / (double)report->pairs);
+}
+
+//compares the block a = (i, j) of rows x cols elements (both at most 8) with its mirror b = (j, i), rows ld
+//floats apart, transposed in registers. Returns the mask of the asymmetric pairs, bit 8 * k + l for the
+//element (k, l) of a, and adds their deviations to the running maximum and sum of squares. On a diagonal
+//block (i == j) only the pairs above the diagonal count. The deviations are computed in double precision:
+//the difference of two finite floats, and its square, can overflow in single precision but not in double
+static inline SIMD_TARGET_AVX2 unsigned long long asymmetryBlock8x8(const float *a, const float *b, int ld, int rows, int cols, int diagonal,
+                                                                    __m256d *max_deviation, __m256d *sum_squares) {
+    const __m256d sign = _mm256_set1_pd(-0.0);
+    const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    __m256 row_a[8];
+    __m256 row_b[8];
+    // the lanes outside partial blocks are zero on both sides, so they never differ
+    loadMirrorBlocks8x8(a, b, ld, rows, cols, row_a, row_b);
+
+    // Most blocks have no difference at all: those cost no more than in the exact check, with nothing to add
+    __m256 any = _mm256_cmp_ps(row_a[0], row_b[0], _CMP_NEQ_OQ);
+    for (int k = 1; k < rows; k++) {
+        any = _mm256_or_ps(any, _mm256_cmp_ps(row_a[k], row_b[k], _CMP_NEQ_OQ));
+    }
+    if (_mm256_movemask_ps(any) == 0) {
+        return 0;
+    }
+
+    unsigned long long asymmetric = 0;
+    for (int k = 0; k < rows; k++) {
+        __m256 differ = _mm256_cmp_ps(row_a[k], row_b[k], _CMP_NEQ_OQ);
+        if (diagonal) {
+            differ = _mm256_and_ps(differ, _mm256_castsi256_ps(_mm256_cmpgt_epi32(lanes, _mm256_set1_epi32(k))));
+        }
+        asymmetric |= (unsigned long long)_mm256_movemask_ps(differ) << (8 * k);
+
+        // the two halves of the row widened to double, the mask of each 32-bit lane to its 64-bit one
+        for (int half = 0; half < 2; half++) {
+            __m128 a_half = half ? _mm256_extractf128_ps(row_a[k], 1) : _mm256_castps256_ps128(row_a[k]);
+            __m128 b_half = half ? _mm256_extractf128_ps(row_b[k], 1) : _mm256_castps256_ps128(row_b[k]);
+            __m128i differ_half = _mm_castps_si128(half ? _mm256_extractf128_ps(differ, 1) : _mm256_castps256_ps128(differ));
+            __m256d differ_wide = _mm256_castsi256_pd(_mm256_cvtepi32_epi64(differ_half));
+
+            // the deviations of the pairs left out (symmetric, below the diagonal or NaN) are zeroed
+            __m256d deviation = _mm256_sub_pd(_mm256_cvtps_pd(a_half), _mm256_cvtps_pd(b_half));
+            deviation = _mm256_and_pd(_mm256_andnot_pd(sign, deviation), differ_wide);
+            *max_deviation = _mm256_max_pd(*max_deviation, deviation);
+            *sum_squares = _mm256_add_pd(*sum_squares, _mm256_mul_pd(deviation, deviation));
+        }
+    }
+    return asymmetric;
+}
+
+//reports the asymmetries of the pairs (i, j) with first_row <= i < last_row and i < j of the square matrix,
+//keeping the first max_positions positions (at most SYM_REPORT_MAX_POSITIONS). The rows of tiles are
+//shared among the OpenMP threads: each one fills a report of its own, merged into the result once it is
+//done, so nothing is shared inside the loop. Returns 0 if the matrix is not square (nothing is reported)
+static inline SIMD_TARGET_AVX2 int reportAsymmetryRows(const Matrix *matrix, int first_row, int last_row, int max_positions, SymReport *report) {
+    const int blockSize = 8;
+    memset(report, 0, sizeof(*report));
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+    int n = matrix->rows;
+    if (max_positions > SYM_REPORT_MAX_POSITIONS) {
+        max_positions = SYM_REPORT_MAX_POSITIONS;
+    }
+    if (max_positions < 0) {
+        max_positions = 0;
+    }
+    int tiles = (last_row - first_row + SYM_TOLERANCE_TILE - 1) / SYM_TOLERANCE_TILE;
+
+    #pragma omp parallel
+    {
+        SymReport local;
+        memset(&local, 0, sizeof(local));
+        __m256d max_deviation = _mm256_setzero_pd();
+        __m256d sum_squares = _mm256_setzero_pd();
+
+        // the same tiles as checkSymTolerance, so that the mirrors are read from the cache as often; the first
+        // rows of tiles have the most tiles, so they are handed out dynamically
+        #pragma omp for schedule(dynamic)
+        for (int ti = 0; ti < tiles; ti++) {
+            int i1 = first_row + ti * SYM_TOLERANCE_TILE;
+            int i1_end = (i1 + SYM_TOLERANCE_TILE < last_row) ? i1 + SYM_TOLERANCE_TILE : last_row;
+            for (int i = i1; i < i1_end; i++) {
+                local.pairs += n - 1 - i;
+            }
+
+            for (int j1 = i1; j1 < n; j1 += SYM_TOLERANCE_TILE) {
+                int j1_end = (j1 + SYM_TOLERANCE_TILE < n) ? j1 + SYM_TOLERANCE_TILE : n;
+                for (int i = i1; i < i1_end; i += blockSize) {
+                    int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                    // inside a diagonal tile start from the diagonal block, the blocks below it are the mirrors
+                    for (int j = (i1 == j1) ? i : j1; j < j1_end; j += blockSize) {
+                        int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                        unsigned long long asymmetric = asymmetryBlock8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld, block_rows, block_cols, i == j, &max_deviation, &sum_squares);
+                        if (asymmetric == 0) {
+                            continue;
+                        }
+                        local.asymmetric += __builtin_popcountll(asymmetric);
+                        // with no positions asked only the count and the deviations are kept
+                        if (max_positions == 0) {
+                            continue;
+                        }
+
+                        // the positions of the block, unless all of them come after those already kept
+                        int full = local.positions == max_positions;
+                        if (!full || i < local.position_rows[max_positions - 1] || (i == local.position_rows[max_positions - 1] && j < local.position_cols[max_positions - 1])) {
+                            while (asymmetric != 0) {
+                                int bit = __builtin_ctzll(asymmetric);
+                                recordAsymmetricPair(&local, max_positions, i + bit / 8, j + bit % 8);
+                                asymmetric &= asymmetric - 1;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // horizontal maximum and sum of the lanes, then the merge, once per thread
+        double lanes_max[4];
+        double lanes_sum[4];
+        _mm256_storeu_pd(lanes_max, max_deviation);
+        _mm256_storeu_pd(lanes_sum, sum_squares);
+        for (int l = 0; l < 4; l++) {
+            if (lanes_max[l] > local.max_deviation) {
+                local.max_deviation = lanes_max[l];
+            }
+        }
+        local.sum_squares = lanes_sum[0] + lanes_sum[1] + lanes_sum[2] + lanes_sum[3];
+
+        #pragma omp critical
+        mergeSymReports(report, &local, max_positions);
+    }
+    return 1;
+}
+
+//makes pairs distinct pairs of the square matrix asymmetric, at random: the element below the diagonal
+//moves away from its mirror by more than its own magnitude (to try the report on a known answer)
+static inline void plantAsymmetries(Matrix *matrix, int pairs) {
+    int n = (matrix->rows < matrix->cols) ? matrix->rows : matrix->cols;
+    long long available = (long long)n * (n - 1) / 2;
+    if (pairs > available) {
+        pairs = (int)available;
+    }
+    while (pairs > 0) {
+        int i = rand() % n;
+        int j = rand() % n;
+        // each pair once, from below the diagonal
+        if (j >= i || MAT(matrix, i, j) != MAT(matrix, j, i)) {
+            continue;
+        }
+        MAT(matrix, i, j) = -MAT(matrix, i, j) - 1.0f;
+        pairs--;
+    }
+}
+
+//reports the asymmetries of the whole square matrix (see reportAsymmetryRows). Returns 0 if it is not square
+static inline SIMD_TARGET_AVX2 int reportAsymmetry(const Matrix *matrix, int max_positions, SymReport *report) {
+    return reportAsymmetryRows(matrix, 0, matrix->rows, max_positions, report);
+}
+
+#endif
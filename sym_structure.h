@@ -0,0 +1,241 @@
+#ifndef SYM_STRUCTURE_H
+#define SYM_STRUCTURE_H
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <immintrin.h>
+#include "matrix.h"
+#include "simd_kernels.h"
+#include "sym_tiles.h"
+
+// Side (in elements) of the tiles of the SIMD and OpenMP engines, as in checkSymTolerance
+#define SYM_STRUCTURE_TILE 32
+
+// The structures a square matrix can be checked for. Each one is a_ij = f(a_ji) with f applied to the mirror
+// on the fly, in the same pass as the compare: f(x) = x (symmetric, the reference), f(x) = -x (skew-symmetric,
+// which forces a zero diagonal) or f(x) = conj(x) (Hermitian, which forces a real diagonal). A Hermitian
+// matrix of n x n complex elements is stored as a Matrix of n x 2n floats, each element as its real part
+// followed by its imaginary part (as complex_float in typed_kernels.h)
+typedef enum {
+    STRUCTURE_SYMMETRIC,
+    STRUCTURE_SKEW_SYMMETRIC,
+    STRUCTURE_HERMITIAN
+} MatrixStructure;
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns the name of the structure
+static inline const char *structureName(MatrixStructure structure) {
+    switch (structure) {
+        case STRUCTURE_SKEW_SYMMETRIC: return "skew-symmetric";
+        case STRUCTURE_HERMITIAN: return "Hermitian";
+        default: return "symmetric";
+    }
+}
+
+//returns the side in elements of the matrix if it is square for the structure (n x n floats, or n x 2n
+//floats for n x n complex elements), -1 otherwise
+static inline int structureSide(const Matrix *matrix, MatrixStructure structure) {
+    int cols = (structure == STRUCTURE_HERMITIAN) ? matrix->cols / 2 : matrix->cols;
+    if (structure == STRUCTURE_HERMITIAN && matrix->cols % 2 != 0) {
+        return -1;
+    }
+    return (matrix->rows == cols) ? matrix->rows : -1;
+}
+
+//initializes the matrix with random values and gives it the structure: the elements above the diagonal are
+//random and mirrored below it through f, the diagonal is zero (skew-symmetric) or real (Hermitian)
+static inline void initializeStructuredMatrix(Matrix *matrix, MatrixStructure structure) {
+    int n = structureSide(matrix, structure);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            if (structure == STRUCTURE_HERMITIAN) {
+                float *element = &MAT(matrix, i, 2 * j);
+                if (j < i) {
+                    element[0] = MAT(matrix, j, 2 * i);
+                    element[1] = -MAT(matrix, j, 2 * i + 1);
+                } else {
+                    element[0] = (float)rand();
+                    element[1] = (j == i) ? 0.0f : (float)rand();
+                }
+            } else if (j < i) {
+                MAT(matrix, i, j) = (structure == STRUCTURE_SKEW_SYMMETRIC) ? -MAT(matrix, j, i) : MAT(matrix, j, i);
+            } else {
+                MAT(matrix, i, j) = (structure == STRUCTURE_SKEW_SYMMETRIC && j == i) ? 0.0f : (float)rand();
+            }
+        }
+    }
+}
+
+//checks if the matrix has the structure one element at a time (runs on any CPU): every element on and below
+//the diagonal against f of its mirror, which on the diagonal is the element itself
+static inline int checkStructureScalar(const Matrix *matrix, MatrixStructure structure) {
+    int n = structureSide(matrix, structure);
+    if (n < 0) {
+        return 0;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            if (structure == STRUCTURE_HERMITIAN) {
+                if (MAT(matrix, i, 2 * j) != MAT(matrix, j, 2 * i) || MAT(matrix, i, 2 * j + 1) != -MAT(matrix, j, 2 * i + 1)) {
+                    return 0;
+                }
+            } else if (MAT(matrix, i, j) != ((structure == STRUCTURE_SKEW_SYMMETRIC) ? -MAT(matrix, j, i) : MAT(matrix, j, i))) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+//returns 1 if the block a = (i, j) of rows x cols floats (both at most 8) equals its mirror b = (j, i),
+//loaded and transposed in registers by loadMirrorBlocks8x8, with the bits of flip toggled (-0 in every lane negates the mirror, 0 leaves it
+//as it is). The lanes outside the blocks are zero on both sides
+static inline SIMD_TARGET_AVX2 int mirroredBlocks8x8(const float *a, const float *b, int ld, int rows, int cols, __m256 flip) {
+    __m256 row_a[8];
+    __m256 row_b[8];
+
+    loadMirrorBlocks8x8(a, b, ld, rows, cols, row_a, row_b);
+
+    // the sign flip is one xor per row, fused with the compare: a single movemask decides for the whole block
+    __m256 differ = _mm256_setzero_ps();
+    for (int k = 0; k < rows; k++) {
+        differ = _mm256_or_ps(differ, _mm256_cmp_ps(row_a[k], _mm256_xor_ps(row_b[k], flip), _CMP_NEQ_OQ));
+    }
+    return _mm256_movemask_ps(differ) == 0;
+}
+
+//transposes in registers the 4x4 block of complex elements (64 bits each) held in row[0..3]: at the end row[k]
+//contains the k-th column, the real and imaginary parts of every element staying together
+static inline SIMD_TARGET_AVX2 void transpose4x4ComplexRegisters(__m256 row[4]) {
+    // Interleave pairs of rows: 2x2 blocks of elements transposed inside every 128-bit lane
+    __m256d t0 = _mm256_unpacklo_pd(_mm256_castps_pd(row[0]), _mm256_castps_pd(row[1]));
+    __m256d t1 = _mm256_unpackhi_pd(_mm256_castps_pd(row[0]), _mm256_castps_pd(row[1]));
+    __m256d t2 = _mm256_unpacklo_pd(_mm256_castps_pd(row[2]), _mm256_castps_pd(row[3]));
+    __m256d t3 = _mm256_unpackhi_pd(_mm256_castps_pd(row[2]), _mm256_castps_pd(row[3]));
+
+    // Exchange the 128-bit lanes
+    row[0] = _mm256_castpd_ps(_mm256_permute2f128_pd(t0, t2, 0x20));
+    row[1] = _mm256_castpd_ps(_mm256_permute2f128_pd(t1, t3, 0x20));
+    row[2] = _mm256_castpd_ps(_mm256_permute2f128_pd(t0, t2, 0x31));
+    row[3] = _mm256_castpd_ps(_mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+//returns 1 if the block a = (i, j) of rows x cols complex elements (both at most 4) is the conjugate of its
+//mirror b = (j, i) transposed in registers (rows ld floats apart): the conjugate only toggles the sign of
+//the imaginary lanes, in the same xor as the compare
+static inline SIMD_TARGET_AVX2 int hermitianBlocks4x4(const float *a, const float *b, int ld, int rows, int cols) {
+    const __m256 conjugate = _mm256_setr_ps(0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f, 0.0f, -0.0f);
+    __m256 row_a[4];
+    __m256 row_b[4];
+
+    if (rows == 4 && cols == 4) {
+        for (int k = 0; k < 4; k++) {
+            row_a[k] = _mm256_loadu_ps(a + (size_t)k * ld);
+            row_b[k] = _mm256_loadu_ps(b + (size_t)k * ld);
+        }
+    } else {
+        // two float lanes per element
+        __m256i rows_mask = laneMask8(2 * rows);
+        __m256i cols_mask = laneMask8(2 * cols);
+        for (int k = 0; k < 4; k++) {
+            row_a[k] = (k < rows) ? _mm256_maskload_ps(a + (size_t)k * ld, cols_mask) : _mm256_setzero_ps();
+            row_b[k] = (k < cols) ? _mm256_maskload_ps(b + (size_t)k * ld, rows_mask) : _mm256_setzero_ps();
+        }
+    }
+
+    transpose4x4ComplexRegisters(row_b);
+
+    __m256 differ = _mm256_setzero_ps();
+    for (int k = 0; k < rows; k++) {
+        differ = _mm256_or_ps(differ, _mm256_cmp_ps(row_a[k], _mm256_xor_ps(row_b[k], conjugate), _CMP_NEQ_OQ));
+    }
+    return _mm256_movemask_ps(differ) == 0;
+}
+
+//the block test of checkMirrorBlocks for the structure in data: the block of rows x cols elements at (i, j)
+//against f of its mirror (8x8 floats, or 4x4 complex elements for the Hermitian structure)
+static inline SIMD_TARGET_AVX2 int structureBlock(const Matrix *matrix, const void *data, int i, int j, int rows, int cols) {
+    MatrixStructure structure = *(const MatrixStructure *)data;
+    // the floats per element, to turn the positions into offsets
+    const int width = (structure == STRUCTURE_HERMITIAN) ? 2 : 1;
+    const float *a = &MAT(matrix, i, width * j);
+    const float *b = &MAT(matrix, j, width * i);
+
+    if (structure == STRUCTURE_HERMITIAN) {
+        return hermitianBlocks4x4(a, b, matrix->ld, rows, cols);
+    }
+    const __m256 flip = (structure == STRUCTURE_SKEW_SYMMETRIC) ? _mm256_set1_ps(-0.0f) : _mm256_setzero_ps();
+    return mirroredBlocks8x8(a, b, matrix->ld, rows, cols, flip);
+}
+
+//returns the side of the blocks of structureBlock: 8 floats, or 4 complex elements
+static inline int structureBlockSize(MatrixStructure structure) {
+    return (structure == STRUCTURE_HERMITIAN) ? 4 : 8;
+}
+
+//checks if the matrix has the structure with AVX2, in the style of sym_check_vectorization_8.c: the tiles on
+//and above the diagonal and their mirrors, transposed in registers and compared through f in one pass
+static inline SIMD_TARGET_AVX2 int checkStructureAVX2(const Matrix *matrix, MatrixStructure structure) {
+    int n = structureSide(matrix, structure);
+    if (n < 0) {
+        return 0;
+    }
+    const int blockSize = structureBlockSize(structure);
+
+    for (int i1 = 0; i1 < n; i1 += SYM_STRUCTURE_TILE) {
+        int i1_end = (i1 + SYM_STRUCTURE_TILE < n) ? i1 + SYM_STRUCTURE_TILE : n;
+        for (int j1 = i1; j1 < n; j1 += SYM_STRUCTURE_TILE) {
+            int j1_end = (j1 + SYM_STRUCTURE_TILE < n) ? j1 + SYM_STRUCTURE_TILE : n;
+            for (int i = i1; i < i1_end; i += blockSize) {
+                int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                // inside a diagonal tile start from the diagonal block (compared with itself), the blocks below it are the mirrors
+                for (int j = (i1 == j1) ? i : j1; j < j1_end; j += blockSize) {
+                    int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                    if (!structureBlock(matrix, &structure, i, j, block_rows, block_cols)) {
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    return 1;
+}
+
+//same as checkStructureAVX2 with the bands of tiles shared among the OpenMP threads by checkMirrorBlocks,
+//which all stop within one tile of the first mismatch (as checkSymTolerance)
+static inline SIMD_TARGET_AVX2 int checkStructureOpenMP(const Matrix *matrix, MatrixStructure structure) {
+    int n = structureSide(matrix, structure);
+    if (n < 0) {
+        return 0;
+    }
+    return checkMirrorBlocks(matrix, n, SYM_STRUCTURE_TILE, structureBlockSize(structure), structureBlock, &structure);
+}
+
+//checks if the matrix is skew-symmetric (a_ij = -a_ji, zero diagonal): one element at a time, with AVX2, with AVX2 and OpenMP
+static inline int checkSkewSymScalar(const Matrix *matrix) {
+    return checkStructureScalar(matrix, STRUCTURE_SKEW_SYMMETRIC);
+}
+static inline SIMD_TARGET_AVX2 int checkSkewSymAVX2(const Matrix *matrix) {
+    return checkStructureAVX2(matrix, STRUCTURE_SKEW_SYMMETRIC);
+}
+static inline SIMD_TARGET_AVX2 int checkSkewSymOpenMP(const Matrix *matrix) {
+    return checkStructureOpenMP(matrix, STRUCTURE_SKEW_SYMMETRIC);
+}
+
+//checks if the matrix of complex elements is Hermitian (a_ij = conj(a_ji), real diagonal): one element at a
+//time, with AVX2, with AVX2 and OpenMP
+static inline int checkHermitianScalar(const Matrix *matrix) {
+    return checkStructureScalar(matrix, STRUCTURE_HERMITIAN);
+}
+static inline SIMD_TARGET_AVX2 int checkHermitianAVX2(const Matrix *matrix) {
+    return checkStructureAVX2(matrix, STRUCTURE_HERMITIAN);
+}
+static inline SIMD_TARGET_AVX2 int checkHermitianOpenMP(const Matrix *matrix) {
+    return checkStructureOpenMP(matrix, STRUCTURE_HERMITIAN);
+}
+
+#endif
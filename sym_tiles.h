@@ -0,0 +1,66 @@
+#ifndef SYM_TILES_H
+#define SYM_TILES_H
+
+#include "matrix.h"
+
+// A test of the block of rows x cols elements at (i, j), on or above the diagonal, against its mirror at
+// (j, i), with the arguments of the check in data: returns 1 if the two match. On the diagonal (i == j) the
+// block is its own mirror
+typedef int (*MirrorBlockTest)(const Matrix *matrix, const void *data, int i, int j, int rows, int cols);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns 1 if test holds for every block of side block on and above the diagonal of the square matrix (n x n
+//elements, the rows and columns past the last full block in smaller blocks). The blocks are grouped in tiles
+//of side tile (a multiple of block), and the bands of tiles are shared among the OpenMP threads: the bands
+//at the top have the most tiles, so they are handed out dynamically. A shared flag is read before each tile,
+//so once one block fails every thread stops within one tile; with OMP_CANCELLATION=true the bands not
+//started yet are dropped as well, at the cancellation point that follows the tile loop of every band
+static inline int checkMirrorBlocks(const Matrix *matrix, int n, int tile, int block, MirrorBlockTest test, const void *data) {
+    int tiles = (n + tile - 1) / tile;
+    int mismatch = 0;
+
+    // The for construct is not combined with the parallel one: GCC makes the for of a combined parallel
+    // for nowait, and a nowait for cannot be cancelled
+    #pragma omp parallel
+    {
+        #pragma omp for schedule(dynamic)
+        for (int ti = 0; ti < tiles; ti++) {
+            int i1 = ti * tile;
+            int i1_end = (i1 + tile < n) ? i1 + tile : n;
+            for (int j1 = i1; j1 < n; j1 += tile) {
+                int stop;
+                #pragma omp atomic read
+                stop = mismatch;
+                if (stop) {
+                    break;
+                }
+
+                int j1_end = (j1 + tile < n) ? j1 + tile : n;
+                int matches = 1;
+                for (int i = i1; i < i1_end && matches; i += block) {
+                    int block_rows = (i1_end - i < block) ? i1_end - i : block;
+                    // inside a diagonal tile start from the diagonal block, the blocks below it are the mirrors
+                    for (int j = (i1 == j1) ? i : j1; j < j1_end && matches; j += block) {
+                        int block_cols = (j1_end - j < block) ? j1_end - j : block;
+                        matches = test(matrix, data, i, j, block_rows, block_cols);
+                    }
+                }
+
+                if (!matches) {
+                    #pragma omp atomic write
+                    mismatch = 1;
+                    #pragma omp cancel for
+                    break;
+                }
+            }
+            #pragma omp cancellation point for
+        }
+    }
+    return !mismatch;
+}
+
+#endif
@@ -0,0 +1,124 @@
+#ifndef SYM_TOLERANCE_H
+#define SYM_TOLERANCE_H
+
+#include <stddef.h>
+#include <float.h>
+#include <immintrin.h>
+#include "matrix.h"
+#include "simd_kernels.h"
+#include "sym_tiles.h"
+
+// Side (in elements) of the tiles handed to the threads: the flag that stops them is read once per tile
+#define SYM_TOLERANCE_TILE 32
+
+// How far apart a_ij and a_ji may be for the pair to count as symmetric. The pair is accepted as soon as
+// one of the criteria holds (a criterion at 0 only accepts equal values):
+//  * absolute: |a_ij - a_ji| <= absolute
+//  * relative: |a_ij - a_ji| <= relative * max(|a_ij|, |a_ji|)
+//  * ulps: at most ulps representable floats between a_ij and a_ji
+// A NaN is never within any tolerance of anything, while the exact checks (_CMP_NEQ_OQ) let it through. An
+// infinity is only within the absolute and relative tolerances of the same infinity (a_ij - a_ji has to be
+// finite), and within ulps of FLT_MAX of its sign, the float next to it
+typedef struct {
+    float absolute;
+    float relative;
+    int ulps;
+} SymTolerance;
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DEFINITION %%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//the bits of every float turned into integers in the same order as the floats, so that the number of
+//representable floats between two of them is the difference of their keys (-0 and +0 are one apart)
+static inline SIMD_TARGET_AVX2 __m256i orderedKeys8(__m256 x) {
+    __m256i bits = _mm256_castps_si256(x);
+    // negative floats grow in magnitude as their bits grow: their 31 lower bits are flipped
+    __m256i negative = _mm256_srai_epi32(bits, 31);
+    return _mm256_xor_si256(bits, _mm256_and_si256(negative, _mm256_set1_epi32(0x7FFFFFFF)));
+}
+
+//returns the mask of the lanes where a and b are within the tolerance of each other: equal lanes always
+//are, and the criteria left at 0 cost nothing
+static inline SIMD_TARGET_AVX2 __m256 withinTolerance8(__m256 a, __m256 b, const SymTolerance *tolerance) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 close = _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+
+    if (tolerance->absolute > 0.0f || tolerance->relative > 0.0f) {
+        __m256 difference = _mm256_andnot_ps(sign, _mm256_sub_ps(a, b));
+        __m256 magnitude = _mm256_max_ps(_mm256_andnot_ps(sign, a), _mm256_andnot_ps(sign, b));
+        __m256 limit = _mm256_max_ps(_mm256_set1_ps(tolerance->absolute), _mm256_mul_ps(magnitude, _mm256_set1_ps(tolerance->relative)));
+        // an infinite operand makes the limit infinite too: only a finite difference can be within it
+        __m256 finite = _mm256_cmp_ps(difference, _mm256_set1_ps(FLT_MAX), _CMP_LE_OQ);
+        close = _mm256_or_ps(close, _mm256_and_ps(finite, _mm256_cmp_ps(difference, limit, _CMP_LE_OQ)));
+    }
+
+    if (tolerance->ulps > 0) {
+        // The keys of floats of opposite signs can be 2^31 or more apart, which does not fit in a signed
+        // distance: with their sign bits flipped they are in the same order as unsigned integers, and the
+        // larger minus the smaller is the distance, up to 2^32 - 1 without wrapping. The NaNs are left out by
+        // the ordered compare
+        const __m256i flip = _mm256_set1_epi32((int)0x80000000u);
+        __m256i key_a = _mm256_xor_si256(orderedKeys8(a), flip);
+        __m256i key_b = _mm256_xor_si256(orderedKeys8(b), flip);
+        __m256i distance = _mm256_sub_epi32(_mm256_max_epu32(key_a, key_b), _mm256_min_epu32(key_a, key_b));
+        // distance <= ulps as unsigned integers
+        __m256i near = _mm256_cmpeq_epi32(_mm256_min_epu32(distance, _mm256_set1_epi32(tolerance->ulps)), distance);
+        close = _mm256_or_ps(close, _mm256_and_ps(_mm256_castsi256_ps(near), _mm256_cmp_ps(a, b, _CMP_ORD_Q)));
+    }
+    return close;
+}
+
+//returns 1 if the block a = (i, j) of rows x cols floats (both at most 8) is the transpose of its mirror
+//b = (j, i) within the tolerance, rows ld floats apart: the same loads and register transposition as
+//symmetricBlocks8x8, with the compare replaced. The lanes outside partial blocks are zero on both sides,
+//so always close
+static inline SIMD_TARGET_AVX2 int nearlySymmetricBlocks8x8(const float *a, const float *b, int ld, int rows, int cols, const SymTolerance *tolerance) {
+    __m256 row_a[8];
+    __m256 row_b[8];
+    loadMirrorBlocks8x8(a, b, ld, rows, cols, row_a, row_b);
+
+    // Most blocks of a nearly symmetric matrix have no difference at all: those cost no more than the exact check
+    __m256 differ = _mm256_cmp_ps(row_a[0], row_b[0], _CMP_NEQ_UQ);
+    for (int k = 1; k < rows; k++) {
+        differ = _mm256_or_ps(differ, _mm256_cmp_ps(row_a[k], row_b[k], _CMP_NEQ_UQ));
+    }
+    if (_mm256_movemask_ps(differ) == 0) {
+        return 1;
+    }
+
+    __m256 close = withinTolerance8(row_a[0], row_b[0], tolerance);
+    for (int k = 1; k < rows; k++) {
+        close = _mm256_and_ps(close, withinTolerance8(row_a[k], row_b[k], tolerance));
+    }
+    return _mm256_movemask_ps(close) == 0xFF;
+}
+
+//the block test of checkSymTolerance (data is the tolerance, NULL for the exact compare)
+static inline SIMD_TARGET_AVX2 int nearlySymmetricBlock(const Matrix *matrix, const void *data, int i, int j, int rows, int cols) {
+    const SymTolerance *tolerance = data;
+    const float *a = &MAT(matrix, i, j);
+    const float *b = &MAT(matrix, j, i);
+    if (tolerance != NULL) {
+        return nearlySymmetricBlocks8x8(a, b, matrix->ld, rows, cols, tolerance);
+    }
+    if (rows == 8 && cols == 8) {
+        return symmetricBlocks8x8(a, b, matrix->ld);
+    }
+    // remainder rows and columns at the edge of the matrix
+    return symmetricBlocksPartial8x8(a, b, matrix->ld, rows, cols);
+}
+
+//checks if the matrix is symmetric within the tolerance, or exactly if tolerance is NULL (the reference of
+//the throughput: same tiles, same threads, only the compare changes). The bands of tiles on and above the
+//diagonal are shared among the OpenMP threads, which all stop within one tile of the first asymmetry
+static inline SIMD_TARGET_AVX2 int checkSymTolerance(const Matrix *matrix, const SymTolerance *tolerance) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+    return checkMirrorBlocks(matrix, matrix->rows, SYM_TOLERANCE_TILE, 8, nearlySymmetricBlock, tolerance);
+}
+
+#endif
@@ -0,0 +1,669 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <immintrin.h>
+#include <cpuid.h>
+#include "transpose.h"
+#include "simd_kernels.h"
+
+// Side (in elements) of the tiles visited by every transposition kernel: 32x32 floats of source and destination fit in L1
+#define TILE_SIZE 32
+
+// Tile sides (in elements) used by somatcopy, the same defaults as transposition_vectorization_8.c:
+// a 32x32 source tile plus its destination take 8KB of L1 and a 256x256 pair takes 512KB of L2
+#define OMATCOPY_L1_TILE 32
+#define OMATCOPY_L2_TILE 256
+
+// First line of a wisdom file, followed by one tab-separated line per plan
+#define TRANSPOSE_WISDOM_HEADER "# transpose wisdom 1"
+
+// The schedules of the wisdom file by name, at the index of their PLAN_SCHEDULE_* value (planner.h)
+static const char *wisdom_schedule_names[] = {"static", "dynamic"};
+
+// The wisdom of the program: filled by the plans measured and by importTransposeWisdom
+static TransposeWisdom transpose_wisdom[TRANSPOSE_WISDOM_ENTRIES];
+static int transpose_wisdom_entries = 0;
+
+// From the narrowest to the widest: the selection keeps the last one the CPU supports
+static const TransposePath transpose_paths[] = {
+    {"scalar", "scalar (no SIMD)", matTransposeScalar, matTransposeScalarTiled},
+    {"sse", "SSE (4x4 blocks)", matTransposeSSE, matTransposeSSETiled},
+    {"avx2", "AVX2 (8x8 blocks, 16x16 macro-kernel)", matTransposeAVX2, matTransposeAVX2Tiled},
+    {"avx512", "AVX-512 (16x16 blocks)", matTransposeAVX512, matTransposeAVX512Tiled},
+};
+
+static const SymCheckPath sym_check_paths[] = {
+    {"scalar", "scalar (no SIMD)", checkSymScalar},
+    {"sse", "SSE (4 elements)", checkSymSSE},
+    {"avx2", "AVX2 (8 elements)", checkSymAVX2},
+    {"avx512", "AVX-512 (16 elements)", checkSymAVX512},
+};
+
+//transposes the 8x8 block at src into dst, both with rows ld floats apart, with the loads and stores written
+//out one by one: once inlined with a constant ld the block never leaves the registers
+static inline SIMD_TARGET_AVX2 void transposeBlockUnrolled8x8(const float *src, float *dst, int ld) {
+    __m256 row[8];
+    row[0] = _mm256_loadu_ps(src);
+    row[1] = _mm256_loadu_ps(src + ld);
+    row[2] = _mm256_loadu_ps(src + 2 * ld);
+    row[3] = _mm256_loadu_ps(src + 3 * ld);
+    row[4] = _mm256_loadu_ps(src + 4 * ld);
+    row[5] = _mm256_loadu_ps(src + 5 * ld);
+    row[6] = _mm256_loadu_ps(src + 6 * ld);
+    row[7] = _mm256_loadu_ps(src + 7 * ld);
+
+    transpose8x8Registers(row);
+
+    _mm256_storeu_ps(dst, row[0]);
+    _mm256_storeu_ps(dst + ld, row[1]);
+    _mm256_storeu_ps(dst + 2 * ld, row[2]);
+    _mm256_storeu_ps(dst + 3 * ld, row[3]);
+    _mm256_storeu_ps(dst + 4 * ld, row[4]);
+    _mm256_storeu_ps(dst + 5 * ld, row[5]);
+    _mm256_storeu_ps(dst + 6 * ld, row[6]);
+    _mm256_storeu_ps(dst + 7 * ld, row[7]);
+}
+
+// Defines matTransposeFixed<N>: the N x N transposition with its side known at compile time. Every 8x8
+// block sits at a constant offset and the blocks of a TILE_SIZE tile are unrolled completely, so there is
+// no loop control and no edge check left: 16 and 32 are a single straight run of blocks, 64 and 128 repeat
+// the same unrolled tile (unrolling them whole takes up to 100KB of code and runs slower than the loop)
+#define DEFINE_FIXED_SIZE_TRANSPOSE(N) \
+SIMD_TARGET_AVX2 void matTransposeFixed##N(const float *matrix, float *transpose) { \
+    const int tile = (N < TILE_SIZE) ? N : TILE_SIZE; \
+    for (int i1 = 0; i1 < N; i1 += tile) { \
+        for (int j1 = 0; j1 < N; j1 += tile) { \
+            _Pragma("GCC unroll 4") \
+            for (int i = i1; i < i1 + tile; i += 8) { \
+                _Pragma("GCC unroll 4") \
+                for (int j = j1; j < j1 + tile; j += 8) { \
+                    transposeBlockUnrolled8x8(matrix + i * N + j, transpose + j * N + i, N); \
+                } \
+            } \
+        } \
+    } \
+}
+
+DEFINE_FIXED_SIZE_TRANSPOSE(16)
+DEFINE_FIXED_SIZE_TRANSPOSE(32)
+DEFINE_FIXED_SIZE_TRANSPOSE(64)
+DEFINE_FIXED_SIZE_TRANSPOSE(128)
+
+// One fixed size kernel for every exponent from 4 to 7
+static const struct {
+    int side;
+    void (*transpose)(const float *matrix, float *transpose);
+} fixed_size_kernels[] = {
+    {16, matTransposeFixed16},
+    {32, matTransposeFixed32},
+    {64, matTransposeFixed64},
+    {128, matTransposeFixed128},
+};
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+const TransposePath *selectTransposePath(const char *name) {
+    // The features have to be read from cpuid before asking for them
+    __builtin_cpu_init();
+    int supported[] = {
+        1,
+        __builtin_cpu_supports("sse2"),
+        __builtin_cpu_supports("avx2"),
+        __builtin_cpu_supports("avx512f"),
+    };
+
+    const TransposePath *best = NULL;
+    for (int p = 0; p < (int)(sizeof(transpose_paths) / sizeof(transpose_paths[0])); p++) {
+        if (name != NULL && strcmp(name, transpose_paths[p].name) == 0) {
+            return supported[p] ? &transpose_paths[p] : NULL;
+        }
+        if (supported[p]) {
+            best = &transpose_paths[p];
+        }
+    }
+    return (name == NULL) ? best : NULL;
+}
+
+const SymCheckPath *selectSymCheckPath(const char *name) {
+    // The features have to be read from cpuid before asking for them
+    __builtin_cpu_init();
+    int supported[] = {
+        1,
+        __builtin_cpu_supports("sse2"),
+        __builtin_cpu_supports("avx2"),
+        __builtin_cpu_supports("avx512f"),
+    };
+
+    const SymCheckPath *best = NULL;
+    for (int p = 0; p < (int)(sizeof(sym_check_paths) / sizeof(sym_check_paths[0])); p++) {
+        if (name != NULL && strcmp(name, sym_check_paths[p].name) == 0) {
+            return supported[p] ? &sym_check_paths[p] : NULL;
+        }
+        if (supported[p]) {
+            best = &sym_check_paths[p];
+        }
+    }
+    return (name == NULL) ? best : NULL;
+}
+
+int matTransposeFixedSize(const Matrix *matrix, Matrix *transpose) {
+    // The CPU is only inspected on the first call (-1 until then)
+    static int avx2 = -1;
+    if (avx2 < 0) {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    }
+
+    // Only square matrices stored without padding have the layout the kernels are compiled for
+    if (!avx2 || matrix->rows != matrix->cols || matrix->ld != matrix->cols || transpose->ld != matrix->rows) {
+        return 0;
+    }
+    for (int k = 0; k < (int)(sizeof(fixed_size_kernels) / sizeof(fixed_size_kernels[0])); k++) {
+        if (fixed_size_kernels[k].side == matrix->rows) {
+            fixed_size_kernels[k].transpose(matrix->data, transpose->data);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void matTransposeAuto(const Matrix *matrix, Matrix *transpose) {
+    // The small sizes with a kernel of their own skip the generic loops
+    if (matTransposeFixedSize(matrix, transpose)) {
+        return;
+    }
+
+    // The CPU is only inspected on the first call
+    static const TransposePath *path = NULL;
+    if (path == NULL) {
+        path = selectTransposePath(NULL);
+    }
+    path->transpose(matrix, transpose);
+}
+
+int checkSymAuto(const Matrix *matrix) {
+    // The CPU is only inspected on the first call
+    static const SymCheckPath *path = NULL;
+    if (path == NULL) {
+        path = selectSymCheckPath(NULL);
+    }
+    return path->checkSym(matrix);
+}
+
+//b = alpha * a^T for the rows x cols matrix a (rows lda floats apart) into the cols x rows matrix b (rows
+//ldb floats apart), visiting L2 tiles, then L1 tiles inside them, then 8x8 blocks transposed in registers
+static SIMD_TARGET_AVX2 void somatcopyTransposed(int rows, int cols, float alpha, const float *a, int lda, float *b, int ldb) {
+    const int blockSize = 8;
+
+    // Outer level: tiles sized for L2
+    for (int i2 = 0; i2 < rows; i2 += OMATCOPY_L2_TILE) {
+        int i2_end = (i2 + OMATCOPY_L2_TILE < rows) ? i2 + OMATCOPY_L2_TILE : rows;
+        for (int j2 = 0; j2 < cols; j2 += OMATCOPY_L2_TILE) {
+            int j2_end = (j2 + OMATCOPY_L2_TILE < cols) ? j2 + OMATCOPY_L2_TILE : cols;
+
+            // Middle level: tiles sized for L1 inside the current L2 tile
+            for (int i1 = i2; i1 < i2_end; i1 += OMATCOPY_L1_TILE) {
+                int i1_end = (i1 + OMATCOPY_L1_TILE < i2_end) ? i1 + OMATCOPY_L1_TILE : i2_end;
+                for (int j1 = j2; j1 < j2_end; j1 += OMATCOPY_L1_TILE) {
+                    int j1_end = (j1 + OMATCOPY_L1_TILE < j2_end) ? j1 + OMATCOPY_L1_TILE : j2_end;
+
+                    // Register level: 8x8 blocks, the plain kernels when there is nothing to scale
+                    for (int i = i1; i < i1_end; i += blockSize) {
+                        int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                        for (int j = j1; j < j1_end; j += blockSize) {
+                            int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                            const float *src = a + (size_t)i * lda + j;
+                            float *dst = b + (size_t)j * ldb + i;
+                            if (block_rows == blockSize && block_cols == blockSize) {
+                                if (alpha == 1.0f) {
+                                    transposeBlock8x8(src, lda, dst, ldb);
+                                } else {
+                                    transposeBlockScaled8x8(src, lda, dst, ldb, alpha);
+                                }
+                            } else if (alpha == 1.0f) {
+                                transposeBlockPartial8x8(src, lda, dst, ldb, block_rows, block_cols);
+                            } else {
+                                transposeBlockPartialScaled8x8(src, lda, dst, ldb, block_rows, block_cols, alpha);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//b = alpha * a for the rows x cols matrices a and b (rows lda and ldb floats apart), 8 floats at a time
+static SIMD_TARGET_AVX2 void somatcopyCopy(int rows, int cols, float alpha, const float *a, int lda, float *b, int ldb) {
+    __m256 scale = _mm256_set1_ps(alpha);
+    __m256i tail_mask = laneMask8(cols % 8);
+    int full = cols - cols % 8;
+
+    for (int i = 0; i < rows; i++) {
+        const float *src = a + (size_t)i * lda;
+        float *dst = b + (size_t)i * ldb;
+        for (int j = 0; j < full; j += 8) {
+            _mm256_storeu_ps(dst + j, _mm256_mul_ps(_mm256_loadu_ps(src + j), scale));
+        }
+        if (full < cols) {
+            _mm256_maskstore_ps(dst + full, tail_mask, _mm256_mul_ps(_mm256_maskload_ps(src + full, tail_mask), scale));
+        }
+    }
+}
+
+//b = alpha * a^T without SIMD, for the CPUs without AVX2: the same L1 tiles, one element at a time
+static void somatcopyTransposedScalar(int rows, int cols, float alpha, const float *a, int lda, float *b, int ldb) {
+    for (int i1 = 0; i1 < rows; i1 += OMATCOPY_L1_TILE) {
+        int i1_end = (i1 + OMATCOPY_L1_TILE < rows) ? i1 + OMATCOPY_L1_TILE : rows;
+        for (int j1 = 0; j1 < cols; j1 += OMATCOPY_L1_TILE) {
+            int j1_end = (j1 + OMATCOPY_L1_TILE < cols) ? j1 + OMATCOPY_L1_TILE : cols;
+            for (int i = i1; i < i1_end; i++) {
+                for (int j = j1; j < j1_end; j++) {
+                    b[(size_t)j * ldb + i] = alpha * a[(size_t)i * lda + j];
+                }
+            }
+        }
+    }
+}
+
+//b = alpha * a without SIMD, for the CPUs without AVX2
+static void somatcopyCopyScalar(int rows, int cols, float alpha, const float *a, int lda, float *b, int ldb) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            b[(size_t)i * ldb + j] = alpha * a[(size_t)i * lda + j];
+        }
+    }
+}
+
+int somatcopy(char trans, int rows, int cols, float alpha, const float *a, int lda, float *b, int ldb) {
+    int transposed = (trans == 'T' || trans == 't');
+    // as in BLAS, the leading dimensions must be at least 1 even for empty matrices
+    int b_cols = transposed ? rows : cols;
+    int min_lda = (cols > 1) ? cols : 1;
+    int min_ldb = (b_cols > 1) ? b_cols : 1;
+
+    if ((!transposed && trans != 'N' && trans != 'n') || rows < 0 || cols < 0 || lda < min_lda || ldb < min_ldb) {
+        return 0;
+    }
+    if (rows == 0 || cols == 0) {
+        return 1;
+    }
+    if (a == NULL || b == NULL) {
+        return 0;
+    }
+
+    // The features have to be read from cpuid before asking for them, once for all the calls
+    static int avx2 = -1;
+    if (avx2 < 0) {
+        __builtin_cpu_init();
+        avx2 = __builtin_cpu_supports("avx2");
+    }
+
+    if (transposed) {
+        if (avx2) {
+            somatcopyTransposed(rows, cols, alpha, a, lda, b, ldb);
+        } else {
+            somatcopyTransposedScalar(rows, cols, alpha, a, lda, b, ldb);
+        }
+    } else if (avx2) {
+        somatcopyCopy(rows, cols, alpha, a, lda, b, ldb);
+    } else {
+        somatcopyCopyScalar(rows, cols, alpha, a, lda, b, ldb);
+    }
+    return 1;
+}
+
+void matTransposeScalar(const Matrix *matrix, Matrix *transpose) {
+    matTransposeScalarTiled(matrix, transpose, TILE_SIZE);
+}
+
+void matTransposeScalarTiled(const Matrix *matrix, Matrix *transpose, int tile) {
+    for (int i1 = 0; i1 < matrix->rows; i1 += tile) {
+        int i1_end = (i1 + tile < matrix->rows) ? i1 + tile : matrix->rows;
+        for (int j1 = 0; j1 < matrix->cols; j1 += tile) {
+            int j1_end = (j1 + tile < matrix->cols) ? j1 + tile : matrix->cols;
+
+            for (int i = i1; i < i1_end; i++) {
+                for (int j = j1; j < j1_end; j++) {
+                    MAT(transpose, j, i) = MAT(matrix, i, j);
+                }
+            }
+        }
+    }
+}
+
+void matTransposeSSE(const Matrix *matrix, Matrix *transpose) {
+    matTransposeSSETiled(matrix, transpose, TILE_SIZE);
+}
+
+SIMD_TARGET_SSE void matTransposeSSETiled(const Matrix *matrix, Matrix *transpose, int tile) {
+    const int blockSize = 4;
+
+    for (int i1 = 0; i1 < matrix->rows; i1 += tile) {
+        int i1_end = (i1 + tile < matrix->rows) ? i1 + tile : matrix->rows;
+        for (int j1 = 0; j1 < matrix->cols; j1 += tile) {
+            int j1_end = (j1 + tile < matrix->cols) ? j1 + tile : matrix->cols;
+
+            for (int i = i1; i < i1_end; i += blockSize) {
+                for (int j = j1; j < j1_end; j += blockSize) {
+                    if (i + blockSize <= i1_end && j + blockSize <= j1_end) {
+                        transposeBlock4x4(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld);
+                    } else {
+                        // remainder rows and columns at the edge of the matrix
+                        for (int ii = i; ii < i + blockSize && ii < i1_end; ii++) {
+                            for (int jj = j; jj < j + blockSize && jj < j1_end; jj++) {
+                                MAT(transpose, jj, ii) = MAT(matrix, ii, jj);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void matTransposeAVX2(const Matrix *matrix, Matrix *transpose) {
+    matTransposeAVX2Tiled(matrix, transpose, TILE_SIZE);
+}
+
+SIMD_TARGET_AVX2 void matTransposeAVX2Tiled(const Matrix *matrix, Matrix *transpose, int tile) {
+    const int blockSize = 8;
+    // full 16x16 squares go through the macro-kernel, the rest of the tile in 8x8 blocks
+    const int macroSize = 2 * blockSize;
+
+    for (int i1 = 0; i1 < matrix->rows; i1 += tile) {
+        int i1_end = (i1 + tile < matrix->rows) ? i1 + tile : matrix->rows;
+        for (int j1 = 0; j1 < matrix->cols; j1 += tile) {
+            int j1_end = (j1 + tile < matrix->cols) ? j1 + tile : matrix->cols;
+
+            for (int i2 = i1; i2 < i1_end; i2 += macroSize) {
+                for (int j2 = j1; j2 < j1_end; j2 += macroSize) {
+                    if (i2 + macroSize <= i1_end && j2 + macroSize <= j1_end) {
+                        transposeBlockMacro16x16(&MAT(matrix, i2, j2), matrix->ld, &MAT(transpose, j2, i2), transpose->ld);
+                        continue;
+                    }
+
+                    for (int i = i2; i < i2 + macroSize && i < i1_end; i += blockSize) {
+                        int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                        for (int j = j2; j < j2 + macroSize && j < j1_end; j += blockSize) {
+                            int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                            if (block_rows == blockSize && block_cols == blockSize) {
+                                transposeBlock8x8(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld);
+                            } else {
+                                transposeBlockPartial8x8(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, block_rows, block_cols);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+void matTransposeAVX512(const Matrix *matrix, Matrix *transpose) {
+    matTransposeAVX512Tiled(matrix, transpose, TILE_SIZE);
+}
+
+SIMD_TARGET_AVX512 void matTransposeAVX512Tiled(const Matrix *matrix, Matrix *transpose, int tile) {
+    const int blockSize = 16;
+
+    for (int i1 = 0; i1 < matrix->rows; i1 += tile) {
+        int i1_end = (i1 + tile < matrix->rows) ? i1 + tile : matrix->rows;
+        for (int j1 = 0; j1 < matrix->cols; j1 += tile) {
+            int j1_end = (j1 + tile < matrix->cols) ? j1 + tile : matrix->cols;
+
+            for (int i = i1; i < i1_end; i += blockSize) {
+                int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                for (int j = j1; j < j1_end; j += blockSize) {
+                    int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                    if (block_rows == blockSize && block_cols == blockSize) {
+                        transposeBlock16x16(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld);
+                    } else {
+                        transposeBlockPartial16x16(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, block_rows, block_cols);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int checkSymScalar(const Matrix *matrix) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < i; j++) {
+            if (MAT(matrix, i, j) != MAT(matrix, j, i)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+SIMD_TARGET_SSE int checkSymSSE(const Matrix *matrix) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+    for (int i = 0; i < matrix->rows; i++) {
+        int j;
+        for (j = 0; j + 4 <= i; j += 4) {
+            __m128 row_vec = _mm_loadu_ps(&MAT(matrix, i, j));
+            __m128 col_vec = _mm_set_ps(MAT(matrix, j + 3, i), MAT(matrix, j + 2, i), MAT(matrix, j + 1, i), MAT(matrix, j, i));
+            if (_mm_movemask_ps(_mm_cmpneq_ps(row_vec, col_vec)) != 0) {
+                return 0;
+            }
+        }
+        // SSE has no masked loads: the remainder before the diagonal is checked element by element
+        for (; j < i; j++) {
+            if (MAT(matrix, i, j) != MAT(matrix, j, i)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+SIMD_TARGET_AVX2 int checkSymAVX2(const Matrix *matrix) {
+    const int blockSize = 8;
+    int n = matrix->rows;
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+
+    // The 8x8 tiles on and above the diagonal against their mirrors, transposed in registers
+    for (int i = 0; i < n; i += blockSize) {
+        int block_rows = (n - i < blockSize) ? n - i : blockSize;
+        for (int j = i; j < n; j += blockSize) {
+            int block_cols = (n - j < blockSize) ? n - j : blockSize;
+            int symmetric = (block_rows == blockSize && block_cols == blockSize)
+                ? symmetricBlocks8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld)
+                : symmetricBlocksPartial8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld, block_rows, block_cols);
+            if (!symmetric) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+SIMD_TARGET_AVX512 int checkSymAVX512(const Matrix *matrix) {
+    // A rectangular matrix can never be symmetric
+    if (matrix->rows != matrix->cols) {
+        return 0;
+    }
+
+    // Distance (in floats) of 16 consecutive elements of a column from the first one
+    __m512i column_offsets = _mm512_mullo_epi32(_mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15), _mm512_set1_epi32(matrix->ld));
+
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < i; j += 16) {
+            __mmask16 mask = (i - j < 16) ? (__mmask16)((1u << (i - j)) - 1) : (__mmask16)0xFFFF;
+            __m512 row_vec = _mm512_maskz_loadu_ps(mask, &MAT(matrix, i, j));
+            __m512 col_vec = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), mask, column_offsets, &MAT(matrix, j, i), sizeof(float));
+            if (_mm512_mask_cmp_ps_mask(mask, row_vec, col_vec, _CMP_NEQ_OQ) != 0) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
+
+const char *transposeCpuModel(void) {
+    static char model[64] = "";
+    if (model[0] == '\0') {
+        unsigned int regs[12];
+        if (__get_cpuid(0x80000002, &regs[0], &regs[1], &regs[2], &regs[3]) &&
+            __get_cpuid(0x80000003, &regs[4], &regs[5], &regs[6], &regs[7]) &&
+            __get_cpuid(0x80000004, &regs[8], &regs[9], &regs[10], &regs[11])) {
+            // the brand string is padded with spaces on some CPUs: they are dropped, and tabs are field separators in the file
+            const char *brand = (const char *)regs;
+            int length = 0;
+            for (int k = 0; k < 48 && brand[k] != '\0'; k++) {
+                if (brand[k] != ' ' || (length > 0 && model[length - 1] != ' ')) {
+                    model[length++] = (brand[k] == '\t') ? ' ' : brand[k];
+                }
+            }
+            while (length > 0 && model[length - 1] == ' ') {
+                length--;
+            }
+            model[length] = '\0';
+        }
+        if (model[0] == '\0') {
+            strcpy(model, "unknown");
+        }
+    }
+    return model;
+}
+
+const TransposeWisdom *findTransposeWisdom(const char *cpu, int rows, int cols, int lds, int ldd, int max_threads) {
+    for (int e = 0; e < transpose_wisdom_entries; e++) {
+        const TransposeWisdom *entry = &transpose_wisdom[e];
+        if (entry->rows == rows && entry->cols == cols && entry->lds == lds && entry->ldd == ldd &&
+            entry->max_threads == max_threads && strcmp(entry->cpu, cpu) == 0) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+int storeTransposeWisdom(const TransposeWisdom *entry) {
+    const TransposeWisdom *found = findTransposeWisdom(entry->cpu, entry->rows, entry->cols, entry->lds, entry->ldd, entry->max_threads);
+    if (found != NULL) {
+        transpose_wisdom[found - transpose_wisdom] = *entry;
+        return 1;
+    }
+    if (transpose_wisdom_entries == TRANSPOSE_WISDOM_ENTRIES) {
+        return 0;
+    }
+    transpose_wisdom[transpose_wisdom_entries++] = *entry;
+    return 1;
+}
+
+int importTransposeWisdom(const char *filename) {
+    FILE *file = fopen(filename, "r");
+    if (file == NULL) {
+        return -1;
+    }
+    char line[256];
+    if (fgets(line, sizeof(line), file) == NULL || strncmp(line, TRANSPOSE_WISDOM_HEADER, strlen(TRANSPOSE_WISDOM_HEADER)) != 0) {
+        fclose(file);
+        return -1;
+    }
+
+    int read = 0;
+    while (fgets(line, sizeof(line), file) != NULL) {
+        // cpu, rows, cols, lds, ldd, max_threads, kernel, tile, threads, schedule and time, separated by tabs
+        TransposeWisdom entry;
+        char schedule[16];
+        if (sscanf(line, "%63[^\t]\t%d\t%d\t%d\t%d\t%d\t%15[^\t]\t%d\t%d\t%15[^\t]\t%lf", entry.cpu, &entry.rows, &entry.cols, &entry.lds,
+                   &entry.ldd, &entry.max_threads, entry.path, &entry.tile, &entry.threads, schedule, &entry.time) != 11) {
+            continue;
+        }
+        entry.schedule = (strcmp(schedule, wisdom_schedule_names[1]) == 0) ? 1 : 0;
+        if (!storeTransposeWisdom(&entry)) {
+            break;
+        }
+        read++;
+    }
+
+    fclose(file);
+    return read;
+}
+
+int exportTransposeWisdom(const char *filename) {
+    FILE *file = fopen(filename, "w");
+    if (file == NULL) {
+        return 0;
+    }
+    fprintf(file, "%s\n", TRANSPOSE_WISDOM_HEADER);
+    for (int e = 0; e < transpose_wisdom_entries; e++) {
+        const TransposeWisdom *entry = &transpose_wisdom[e];
+        fprintf(file, "%s\t%d\t%d\t%d\t%d\t%d\t%s\t%d\t%d\t%s\t%.9f\n", entry->cpu, entry->rows, entry->cols, entry->lds, entry->ldd,
+                entry->max_threads, entry->path, entry->tile, entry->threads, wisdom_schedule_names[entry->schedule == 1], entry->time);
+    }
+    return fclose(file) == 0;
+}
+
+int invalidateTransposeWisdom(int rows, int cols) {
+    const char *cpu = transposeCpuModel();
+    int removed = 0;
+    int kept = 0;
+    for (int e = 0; e < transpose_wisdom_entries; e++) {
+        const TransposeWisdom *entry = &transpose_wisdom[e];
+        if ((rows == 0 || entry->rows == rows) && (cols == 0 || entry->cols == cols) && strcmp(entry->cpu, cpu) == 0) {
+            removed++;
+        } else {
+            transpose_wisdom[kept++] = *entry;
+        }
+    }
+    transpose_wisdom_entries = kept;
+    return removed;
+}
+
+void initializeMatrix(Matrix *matrix) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < matrix->cols; j++) {
+            MAT(matrix, i, j) = (float)rand();
+        }
+    }
+}
+
+void initializeSymmetricMatrix(Matrix *matrix) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < matrix->cols; j++) {
+            if (j < i && i < matrix->cols) {
+                // the lower triangle mirrors the rows already filled
+                MAT(matrix, i, j) = MAT(matrix, j, i);
+            } else {
+                MAT(matrix, i, j) = (float)rand();
+            }
+        }
+    }
+}
+
+void printMatrix(const Matrix *matrix) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < matrix->cols; j++) {
+            printf("%6.2f ", MAT(matrix, i, j));
+        }
+        printf("\n");
+    }
+}
+
+int matrix_actually_transposed(const Matrix *matrix, const Matrix *transpose) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < matrix->cols; j++) {
+            if (MAT(matrix, i, j) != MAT(transpose, j, i)) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
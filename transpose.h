@@ -0,0 +1,137 @@
+#ifndef TRANSPOSE_H
+#define TRANSPOSE_H
+
+#include "matrix.h"
+
+// Public interface of libtranspose (libtranspose.a and libtranspose.so, built with make): the helpers
+// shared by every benchmark and the transposition and symmetry check kernels chosen at run time from the
+// features of the CPU. The Matrix type and its allocation come from matrix.h, included here.
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%%%%% KERNELS %%%%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// One transposition kernel for every instruction set the library can run on
+typedef struct {
+    const char *name;
+    const char *description;
+    void (*transpose)(const Matrix *matrix, Matrix *transpose);
+    // the same kernel visiting tiles of tile x tile elements instead of 32 x 32 (see planner.h)
+    void (*transposeTiled)(const Matrix *matrix, Matrix *transpose, int tile);
+} TransposePath;
+
+// One symmetry check for every instruction set the library can run on
+typedef struct {
+    const char *name;
+    const char *description;
+    int (*checkSym)(const Matrix *matrix);
+} SymCheckPath;
+
+//returns the widest transposition path supported by the CPU ("scalar", "sse", "avx2" or "avx512"), or
+//the one called name if it is given and supported (NULL otherwise)
+const TransposePath *selectTransposePath(const char *name);
+//returns the widest symmetry check path supported by the CPU, or the one called name if it is given and supported (NULL otherwise)
+const SymCheckPath *selectSymCheckPath(const char *name);
+
+//transposes the rows x cols matrix into the cols x rows transpose with the widest kernel the CPU supports
+//(the fixed size kernel below if there is one for the matrix)
+void matTransposeAuto(const Matrix *matrix, Matrix *transpose);
+//transposes the matrix with the kernel compiled for its size if it is square, 16, 32, 64 or 128 elements
+//wide, stored without padding (ld equal to the side in both matrices) and the CPU has AVX2; returns 0,
+//without touching the transpose, otherwise
+int matTransposeFixedSize(const Matrix *matrix, Matrix *transpose);
+//checks if the matrix is symmetric with the widest kernel the CPU supports
+int checkSymAuto(const Matrix *matrix);
+//out-of-place scaled copy of a row-major matrix, as the omatcopy extension of OpenBLAS and MKL:
+//b = alpha * op(a), with op(a) = a for trans 'N' and op(a) = a^T for trans 'T'. a is rows x cols with its
+//rows lda floats apart, b is rows x cols ('N') or cols x rows ('T') with its rows ldb floats apart, so
+//both can be submatrices of larger buffers (pass the address of their first element and the leading
+//dimension of the whole buffer). a and b must not overlap. The AVX2 kernels run only if the CPU has them,
+//the scalar loops otherwise. Returns 0, leaving b untouched, if the arguments are not valid
+int somatcopy(char trans, int rows, int cols, float alpha, const float *a, int lda, float *b, int ldb);
+
+//transposes the matrix one element at a time (runs on any CPU)
+void matTransposeScalar(const Matrix *matrix, Matrix *transpose);
+//transposes the matrix with the 4x4 SSE kernel (edge blocks element by element, SSE has no masked loads)
+void matTransposeSSE(const Matrix *matrix, Matrix *transpose);
+//transposes the matrix with the 8x8 AVX2 kernel (masked edge blocks)
+void matTransposeAVX2(const Matrix *matrix, Matrix *transpose);
+//transposes the matrix with the 16x16 AVX-512 kernel (masked edge blocks)
+void matTransposeAVX512(const Matrix *matrix, Matrix *transpose);
+//the four kernels above with the side of the tiles they visit as a parameter (32 in the versions above)
+void matTransposeScalarTiled(const Matrix *matrix, Matrix *transpose, int tile);
+void matTransposeSSETiled(const Matrix *matrix, Matrix *transpose, int tile);
+void matTransposeAVX2Tiled(const Matrix *matrix, Matrix *transpose, int tile);
+void matTransposeAVX512Tiled(const Matrix *matrix, Matrix *transpose, int tile);
+
+//transposes the N x N matrix into transpose (both contiguous, N floats per row) with its fully unrolled
+//8x8 AVX2 kernels
+void matTransposeFixed16(const float *matrix, float *transpose);
+void matTransposeFixed32(const float *matrix, float *transpose);
+void matTransposeFixed64(const float *matrix, float *transpose);
+void matTransposeFixed128(const float *matrix, float *transpose);
+
+//checks if the matrix is symmetric one element at a time (runs on any CPU)
+int checkSymScalar(const Matrix *matrix);
+//checks if the matrix is symmetric 4 elements at a time with SSE
+int checkSymSSE(const Matrix *matrix);
+//checks if the matrix is symmetric 8 elements at a time with AVX2 (masked remainder)
+int checkSymAVX2(const Matrix *matrix);
+//checks if the matrix is symmetric 16 elements at a time with AVX-512 (gathered columns, masked remainder)
+int checkSymAVX512(const Matrix *matrix);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%%%%%% WISDOM %%%%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// Plans measured before (see planner.h) can be kept in a wisdom file and read back by the next runs, as
+// FFTW does: an entry is the plan of one size, pair of leading dimensions and limit of threads on one CPU
+// model. The wisdom lives in the library, so that it is one for the whole program: the plans imported or
+// measured by any of its files are seen by all the others. TRANSPOSE_WISDOM_ENTRIES plans are kept at most
+#define TRANSPOSE_WISDOM_ENTRIES 256
+
+// One plan of the wisdom, with the kernel by name so that the entries of other CPUs can be kept as they are
+// (schedule is one of the PLAN_SCHEDULE_* of planner.h, time the seconds per call measured while planning)
+typedef struct {
+    char cpu[64];
+    int rows, cols, lds, ldd, max_threads;
+    char path[16];
+    int tile;
+    int threads;
+    int schedule;
+    double time;
+} TransposeWisdom;
+
+//returns the model of the CPU the program runs on, as the brand string of cpuid ("unknown" if there is none)
+const char *transposeCpuModel(void);
+//returns the entry of the wisdom for the CPU and these sizes, or NULL if there is none
+const TransposeWisdom *findTransposeWisdom(const char *cpu, int rows, int cols, int lds, int ldd, int max_threads);
+//stores the entry in the wisdom, replacing the one of the same sizes and CPU if there is one. Returns 0 if the wisdom is full
+int storeTransposeWisdom(const TransposeWisdom *entry);
+//adds the plans of the wisdom file to the wisdom (the entries of the file replace those with the same sizes
+//and CPU). Returns the number of plans read, or -1 if the file cannot be opened or is not a wisdom file
+int importTransposeWisdom(const char *filename);
+//writes every plan of the wisdom (those of the other CPUs included) to the file. Returns 0 if it cannot be written
+int exportTransposeWisdom(const char *filename);
+//removes from the wisdom the plans of this CPU for a rows x cols matrix (0 for any number of rows or of
+//columns, so that 0, 0 forgets every plan of this CPU), whatever their leading dimensions and threads, so
+//that they are measured again. Returns the number of plans removed
+int invalidateTransposeWisdom(int rows, int cols);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%%%%% HELPERS %%%%%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//initializes the matrix with random values
+void initializeMatrix(Matrix *matrix);
+//initializes the matrix with random values and makes it symmetric (only its square part if it is rectangular)
+void initializeSymmetricMatrix(Matrix *matrix);
+//prints the matrix
+void printMatrix(const Matrix *matrix);
+//checks if the matrix is actually transposed
+int matrix_actually_transposed(const Matrix *matrix, const Matrix *transpose);
+
+#endif
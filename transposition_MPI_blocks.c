@@ -2,20 +2,17 @@
 #include <stdlib.h>
 #include <mpi.h>
 #include <time.h>
+#include "transpose.h"
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-// Initializes the Matrix with random values
-void initializeMatrix(float **matrix, int n);
-// Prints the Matrix
-void printMatrix(float **matrix, int n);
 // Checks if the Matrix is actually transposed
-int matrixActuallyTransposed(float **matrix, float **transpose, int n);
+int matrixActuallyTransposed(const Matrix *matrix, const Matrix *transpose);
 // Transposes the Matrix using MPI Scatterv and Gatherv
-void matTranspose(float *M_flat, int matrix_size, float *local_matrix, float **local_transpose, int rank, int *elements_per_process, int *scatter_displs, int *gather_displs, int *rows_per_process, float **T);
+void matTranspose(const Matrix *M, float *local_matrix, Matrix *local_transpose, int rank, int *elements_per_process, int *scatter_displs, int *gather_displs, int *rows_per_process, Matrix *T);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -40,22 +37,20 @@ int main(int argc, char *argv[]) {
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
+    int rows = 0, cols = 0;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
         if (rank == 0) {
-            printf("Matrix size exponent must be between 4 and 12 (base is 2).\n");
+            printf("Matrix size must be an exponent between 4 and 12 (base is 2) or an explicit size such as 1000x700.\n");
         }
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
-    // Matrix size computation
-    int matrix_size = 1 << exponent;
     // Number of rows per process
-    int base_local_rows = matrix_size / size;
+    int base_local_rows = rows / size;
 
-    if( matrix_size < size ) {
+    if( rows < size ) {
         if(rank == 0) {
-            printf("Matrix size must be greater than or equal to the number of processes.\n");
+            printf("The number of rows must be greater than or equal to the number of processes.\n");
         }
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
@@ -71,9 +66,9 @@ int main(int argc, char *argv[]) {
     int *gather_displs = malloc(size * sizeof(int));
 
     for (int i = 0; i < size; i++) {
-        rows_per_process[i] = base_local_rows + ((i==size-1) ? matrix_size%size : 0);
-        elements_per_process[i] = rows_per_process[i] * matrix_size;
-        scatter_displs[i] = (i == 0) ? 0 : scatter_displs[i - 1] + rows_per_process[i - 1]*matrix_size;
+        rows_per_process[i] = base_local_rows + ((i==size-1) ? rows%size : 0);
+        elements_per_process[i] = rows_per_process[i] * cols;
+        scatter_displs[i] = (i == 0) ? 0 : scatter_displs[i - 1] + rows_per_process[i - 1]*cols;
         gather_displs[i] = (i == 0) ? 0 : gather_displs[i - 1] + rows_per_process[i - 1];
     }
 
@@ -82,23 +77,21 @@ int main(int argc, char *argv[]) {
     // ------------- MATRICES ALLOCATIONS ------------- //
     // ------------------------------------------------ //
 
-    // Matrices for only rank 0
-    float *M_flat = NULL;
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    float **T = (float **)malloc(matrix_size * sizeof(float *));
+    // Matrices for only rank 0 (M is contiguous, so it is scattered directly without any flattening copy)
+    Matrix M = {0}, T = {0};
     if (rank == 0) {
-        M_flat = malloc(matrix_size * matrix_size * sizeof(float));
-        for (int i = 0; i < matrix_size; i++) {
-            T[i] = (float *)malloc(matrix_size * sizeof(float));
-            M[i] = (float *)malloc(matrix_size * sizeof(float));
+        if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+            printf("Unable to allocate the matrices.\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
         }
     }
 
     // Matrices for all the ranks
-    float *local_matrix = malloc(rows_per_process[rank] * matrix_size * sizeof(float));
-    float **local_transpose = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        local_transpose[i] = (float *)malloc(rows_per_process[rank] * sizeof(float));
+    float *local_matrix = malloc(rows_per_process[rank] * cols * sizeof(float));
+    Matrix local_transpose;
+    if (!allocMatrix(&local_transpose, cols, rows_per_process[rank])) {
+        printf("Rank %d is unable to allocate the local transpose.\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
 
     
@@ -110,24 +103,22 @@ int main(int argc, char *argv[]) {
     double total_time = 0.0;
     int iterations = 50;
 
+    if (rank == 0) {
+        srand(time(NULL));
+    }
     MPI_Barrier(MPI_COMM_WORLD);
 
     for(int i = 0; i < iterations; i++){
 
         if (rank == 0) {
-            initializeMatrix(M, matrix_size);
-            for(int i = 0; i < matrix_size; i++) {
-                for(int j = 0; j < matrix_size; j++) {
-                    M_flat[i * matrix_size + j] = M[i][j];
-                }
-            }
+            initializeMatrix(&M);
         }
         
         // Process synchronization befor starting transposition
         MPI_Barrier(MPI_COMM_WORLD);
         double start_time = MPI_Wtime();
 
-        matTranspose(M_flat, matrix_size, local_matrix, local_transpose, rank, elements_per_process, scatter_displs, gather_displs, rows_per_process, T);
+        matTranspose(&M, local_matrix, &local_transpose, rank, elements_per_process, scatter_displs, gather_displs, rows_per_process, &T);
 
         // Synchronize after each repetition
         MPI_Barrier(MPI_COMM_WORLD);
@@ -139,7 +130,7 @@ int main(int argc, char *argv[]) {
             total_time += elapsed_time;
 
             // REMOVE THE COMMENTS BELOW TO CHECK CORRECT TRANSPOSITION
-            // if (matrixActuallyTransposed(M, T, matrix_size)) {
+            // if (matrixActuallyTransposed(&M, &T)) {
             //     printf("Matrix transposed successfully.\n");
             // } else {
             //     printf("Matrix transposition failed.\n");
@@ -152,17 +143,14 @@ int main(int argc, char *argv[]) {
     // ------------------------------------------------ //
     if (rank == 0) {
         double average_time = total_time / iterations;
-        printf("Average time for %d * %d matrix transposition: %f ms\n", matrix_size, matrix_size, average_time*1000);
+        printf("Average time for %d * %d matrix transposition: %f ms\n", rows, cols, average_time*1000);
     }
 
     // ------------------------------------------------ //
     // ----------------- FREE MEMORY ------------------ //
     // ------------------------------------------------ //
 
-    for (int i = 0; i < matrix_size; i++) {
-        free(local_transpose[i]);
-    }
-    free(local_transpose);
+    freeMatrix(&local_transpose);
     free(local_matrix);
 
     free(rows_per_process);
@@ -171,16 +159,10 @@ int main(int argc, char *argv[]) {
     free(gather_displs);
 
     if(rank == 0) {
-        for (int i = 0; i < matrix_size; i++) {
-            free(T[i]);
-            free(M[i]);
-        }
-        free(M_flat);
+        freeMatrix(&T);
+        freeMatrix(&M);
     }
 
-    free(T);
-    free(M);
-
     MPI_Finalize();
     return 0;
 }
@@ -190,28 +172,10 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-void initializeMatrix(float **matrix, int n) {
-    srand(time(NULL));
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (float)rand() / RAND_MAX * 10.0f;
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-int matrixActuallyTransposed(float **matrix, float **transpose, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != transpose[j][i]) {
+int matrixActuallyTransposed(const Matrix *matrix, const Matrix *transpose) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < matrix->cols; j++) {
+            if (MAT(matrix, i, j) != MAT(transpose, j, i)) {
                 return 0;
             }
         }
@@ -219,8 +183,12 @@ int matrixActuallyTransposed(float **matrix, float **transpose, int n) {
     return 1;
 }
 
-void matTranspose(float *M_flat, int matrix_size, float *local_matrix, float **local_transpose, int rank, int *elements_per_process, int *scatter_displs, int *gather_displs, int *rows_per_process, float **T) {
-    MPI_Scatterv(M_flat, elements_per_process, scatter_displs, MPI_FLOAT, local_matrix, rows_per_process[rank] * matrix_size, MPI_FLOAT, 0, MPI_COMM_WORLD);
+void matTranspose(const Matrix *M, float *local_matrix, Matrix *local_transpose, int rank, int *elements_per_process, int *scatter_displs, int *gather_displs, int *rows_per_process, Matrix *T) {
+    // Columns of M, which are the rows of the local transpose
+    int cols = local_transpose->rows;
+
+    // Rank 0 owns M, whose buffer is already laid out row after row as Scatterv expects
+    MPI_Scatterv(M->data, elements_per_process, scatter_displs, MPI_FLOAT, local_matrix, rows_per_process[rank] * cols, MPI_FLOAT, 0, MPI_COMM_WORLD);
 
 
     // REMOVE THE FOLLOWING COMMENT TO SEE IF THE LOCAL MATRIX IS CORRECTLY RECEIVED
@@ -228,8 +196,8 @@ void matTranspose(float *M_flat, int matrix_size, float *local_matrix, float **l
     //     if (rank == i) {
     //         printf("Rank %d\n", rank);
     //         for (int i = 0; i < rows_per_process[rank]; i++) {
-    //             for (int j = 0; j < matrix_size; j++) {
-    //                 printf("%6.2f", local_matrix[i * matrix_size + j]);
+    //             for (int j = 0; j < cols; j++) {
+    //                 printf("%6.2f", local_matrix[i * cols + j]);
     //             }
     //             printf("\n");
     //         }
@@ -241,9 +209,9 @@ void matTranspose(float *M_flat, int matrix_size, float *local_matrix, float **l
     // ------------------------------------------------ //
     // ---------- LOCAL MATRIX TRANSPOSITION ---------- //
     // ------------------------------------------------ //
-    for (int i = 0; i < matrix_size; i++) {
+    for (int i = 0; i < cols; i++) {
         for (int j = 0; j < rows_per_process[rank]; j++) {
-            local_transpose[i][j] = local_matrix[j * matrix_size + i];
+            MAT(local_transpose, i, j) = local_matrix[j * cols + i];
         }
     }
     
@@ -251,9 +219,9 @@ void matTranspose(float *M_flat, int matrix_size, float *local_matrix, float **l
     // for (int i = 0; i < size; i++) {
     //     if (rank == i) {
     //         printf("Rank %d\n", rank);
-    //         for (int i = 0; i < matrix_size; i++) {
+    //         for (int i = 0; i < cols; i++) {
     //             for (int j = 0; j < rows_per_process[rank]; j++) {
-    //                 printf("%6.2f", local_transpose[i][j]);
+    //                 printf("%6.2f", MAT(local_transpose, i, j));
     //             }
     //             printf("\n");
     //         }
@@ -266,7 +234,7 @@ void matTranspose(float *M_flat, int matrix_size, float *local_matrix, float **l
     // -------- GATHERING PARTIAL TRANSPOSITION ------- //
     // ------------------------------------------------ //
 
-    for(int i = 0; i < matrix_size; i++) {
-        MPI_Gatherv(local_transpose[i], rows_per_process[rank], MPI_FLOAT, T[i], rows_per_process, gather_displs, MPI_FLOAT, 0, MPI_COMM_WORLD);
+    for(int i = 0; i < cols; i++) {
+        MPI_Gatherv(matrixRow(local_transpose, i), rows_per_process[rank], MPI_FLOAT, (rank == 0) ? matrixRow(T, i) : NULL, rows_per_process, gather_displs, MPI_FLOAT, 0, MPI_COMM_WORLD);
     }
-}
\ No newline at end of file
+}
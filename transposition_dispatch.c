@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include "transpose.h"
+
+// Back to back calls timed together by -fixed: a single transposition of the small sizes is shorter than
+// the resolution of gettimeofday
+#define FIXED_SIZE_CALLS 1000
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns the average time (in seconds) of the transposition with the kernel of the given path
+double averageTransposeTime(const TransposePath *path, Matrix *M, Matrix *T, int total_iterations);
+//calls matTransposeFixedSize, with the signature of the path kernels
+void transposeFixedSize(const Matrix *matrix, Matrix *transpose);
+//returns the average time (in seconds) of one call of transpose, timing calls transpositions in a row
+double averageCallTime(void (*transpose)(const Matrix *, Matrix *), Matrix *M, Matrix *T, int calls, int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -path scalar|sse|avx2|avx512, -huge, -fixed).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the forced path, if any, from the options
+    const char *path_name = NULL;
+    int huge_pages = 0;
+    int fixed_size = 0;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-path") == 0 && a + 1 < argc) {
+            path_name = argv[++a];
+        } else if (strcmp(argv[a], "-huge") == 0) {
+            huge_pages = 1;
+        } else if (strcmp(argv[a], "-fixed") == 0) {
+            fixed_size = 1;
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Choosing the kernel from the features of the CPU the program is running on
+    const TransposePath *path = selectTransposePath(path_name);
+    if (path == NULL) {
+        printf("The path %s is unknown or not supported by this CPU.\n", path_name);
+        return 1;
+    }
+
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double avg_time = averageTransposeTime(path, &M, &T, total_iterations);
+    printf("Matrix size: %d x %d. Kernel path: %s. Average time taken: %.3fms\n", rows, cols, path->description, avg_time / 1e-3);
+
+    //Running the same kernel on buffers backed by 2MB pages, so that the TLB gain of every path can be compared
+    if (huge_pages) {
+        Matrix HM, HT;
+        if (!allocMatrixHugePages(&HM, rows, cols, cols) || !allocMatrixHugePages(&HT, cols, rows, rows)) {
+            printf("Unable to allocate the huge page matrices.\n");
+            return 1;
+        }
+        double huge_time = averageTransposeTime(path, &HM, &HT, total_iterations);
+        printf("Matrix size: %d x %d. Kernel path: %s. Pages: %s and %s. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, path->description, matrixPagesName(&HM), matrixPagesName(&HT), huge_time / 1e-3, avg_time / huge_time);
+        freeMatrix(&HM);
+        freeMatrix(&HT);
+    }
+
+    //Comparing the kernel compiled for this size with the chosen path, both called FIXED_SIZE_CALLS times in a row
+    if (fixed_size) {
+        if (!matTransposeFixedSize(&M, &T)) {
+            printf("There is no fixed size kernel for a %d x %d matrix on this CPU (only 16, 32, 64 and 128 with AVX2).\n", rows, cols);
+            return 1;
+        }
+        double path_call_time = averageCallTime(path->transpose, &M, &T, FIXED_SIZE_CALLS, total_iterations);
+        double fixed_call_time = averageCallTime(transposeFixedSize, &M, &T, FIXED_SIZE_CALLS, total_iterations);
+        printf("Matrix size: %d x %d. Kernel path: %s. Time per call: %.3fus. Fixed size kernel: %.3fus. Speedup: %.2fx\n", rows, cols, path->description, path_call_time / 1e-6, fixed_call_time / 1e-6, path_call_time / fixed_call_time);
+    }
+
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageTransposeTime(const TransposePath *path, Matrix *M, Matrix *T, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix with the chosen kernel
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        path->transpose(M, T);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T) ? "YES" : "NO");
+
+        // printf("Original Matrix:\n");
+        // printMatrix(M);
+
+        // printf("Transposed Matrix:\n");
+        // printMatrix(T);
+    }
+
+    return total_time / total_iterations;
+}
+
+void transposeFixedSize(const Matrix *matrix, Matrix *transpose) {
+    matTransposeFixedSize(matrix, transpose);
+}
+
+double averageCallTime(void (*transpose)(const Matrix *, Matrix *), Matrix *M, Matrix *T, int calls, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the same matrix calls times, as a caller working on many small matrices would
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        for (int c = 0; c < calls; c++) {
+            transpose(M, T);
+        }
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T) ? "YES" : "NO");
+    }
+
+    return total_time / total_iterations / calls;
+}
@@ -0,0 +1,198 @@
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <omp.h>
+#include "transpose.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//transposes a rows x cols matrix over itself following the cycles of the permutation. The cycles are those
+//of an unpadded buffer: returns 0, leaving the matrix untouched, if its ld is not cols
+int matTransposeInPlaceRect(Matrix *matrix);
+//same as matTransposeInPlaceRect, with the independent cycles moved by different threads (cycle-leader test instead of the bit vector)
+int matTransposeInPlaceRectParallel(Matrix *matrix);
+//returns the average time (in seconds) of one of the two in-place transpositions
+double averageInPlaceTime(Matrix *M, int rows, int cols, int (*transpose)(Matrix *), int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc != 2) {
+        printf("Please add a matrix size as an argument.\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Allocating memory for the matrix M only: the transposition happens inside its own buffer
+    Matrix M;
+    if (!allocMatrix(&M, rows, cols)) {
+        printf("Unable to allocate the matrix.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+
+    double sequential_time = averageInPlaceTime(&M, rows, cols, matTransposeInPlaceRect, total_iterations);
+    double parallel_time = averageInPlaceTime(&M, rows, cols, matTransposeInPlaceRectParallel, total_iterations);
+
+    printf("Matrix size: %d x %d. Sequential in-place: %.3fms. Parallel in-place (%d threads): %.3fms\n", rows, cols, sequential_time / 1e-3, omp_get_max_threads(), parallel_time / 1e-3);
+
+    //Freeing memory
+    freeMatrix(&M);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageInPlaceTime(Matrix *M, int rows, int cols, int (*transpose)(Matrix *), int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Restoring the original shape, since the previous iteration left M transposed
+        M->rows = rows;
+        M->cols = cols;
+        M->ld = cols;
+
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix over itself
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        int transposed = transpose(M);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        if (!transposed) {
+            printf("Unable to transpose a padded matrix in place.\n");
+            exit(1);
+        }
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+    }
+
+    return total_time / total_iterations;
+}
+
+// In a rows x cols row-major buffer of size elements, the element at index k = i * cols + j
+// has to move to index j * rows + i, which is k * rows modulo (size - 1) for every k but the
+// last one (the first and the last element never move). Following this permutation from a
+// starting index gives a cycle of elements that can be moved with a single float of storage.
+
+int matTransposeInPlaceRect(Matrix *matrix) {
+    // The permutation below moves the elements of the whole buffer, padding included
+    if (matrix->ld != matrix->cols) {
+        return 0;
+    }
+    size_t rows = matrix->rows;
+    size_t size = rows * matrix->cols;
+
+    // One bit per element to remember which ones have already reached their place (1/32 of the matrix)
+    unsigned char *moved = calloc((size + 7) / 8, 1);
+    if (moved == NULL) {
+        // without the bit vector the cycles are found with the cycle-leader test, which needs no memory
+        return matTransposeInPlaceRectParallel(matrix);
+    }
+
+    for (size_t start = 1; start + 1 < size; start++) {
+        if (moved[start >> 3] & (1u << (start & 7))) {
+            continue;
+        }
+
+        // Moving the whole cycle that starts here, carrying one element at a time
+        float carry = matrix->data[start];
+        size_t k = start;
+        do {
+            size_t next = (k * rows) % (size - 1);
+            float tmp = matrix->data[next];
+            matrix->data[next] = carry;
+            carry = tmp;
+            moved[next >> 3] |= (unsigned char)(1u << (next & 7));
+            k = next;
+        } while (k != start);
+    }
+
+    free(moved);
+
+    // The buffer now holds the cols x rows transposed matrix
+    matrix->rows = matrix->cols;
+    matrix->cols = (int)rows;
+    matrix->ld = (int)rows;
+    return 1;
+}
+
+int matTransposeInPlaceRectParallel(Matrix *matrix) {
+    // The permutation below moves the elements of the whole buffer, padding included
+    if (matrix->ld != matrix->cols) {
+        return 0;
+    }
+    size_t rows = matrix->rows;
+    size_t size = rows * matrix->cols;
+
+    // Every start index is checked independently: it leads its cycle only if it is the smallest
+    // index of the cycle, so each cycle is moved exactly once and by one thread, with no shared state
+    #pragma omp parallel for schedule(dynamic, 1024)
+    for (size_t start = 1; start < size - 1; start++) {
+        size_t k = (start * rows) % (size - 1);
+        while (k > start) {
+            k = (k * rows) % (size - 1);
+        }
+        if (k != start) {
+            continue;
+        }
+
+        // Moving the whole cycle that starts here, carrying one element at a time
+        float carry = matrix->data[start];
+        k = start;
+        do {
+            size_t next = (k * rows) % (size - 1);
+            float tmp = matrix->data[next];
+            matrix->data[next] = carry;
+            carry = tmp;
+            k = next;
+        } while (k != start);
+    }
+
+    // The buffer now holds the cols x rows transposed matrix
+    matrix->rows = matrix->cols;
+    matrix->cols = (int)rows;
+    matrix->ld = (int)rows;
+    return 1;
+}
@@ -0,0 +1,250 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "transpose.h"
+#include "layouts.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// One storage layout with its conversions from and to row-major and its transposition (both matrices in the layout)
+typedef struct {
+    const char *name;
+    const char *description;
+    int (*supported)(int rows, int cols);
+    int (*fromRowMajor)(const Matrix *matrix, float *layout, int transposed);
+    int (*toRowMajor)(const float *layout, Matrix *matrix);
+    void (*transpose)(const float *layout, float *transpose, int rows, int cols);
+} Layout;
+
+//row-major works for every size
+int rowMajorSupported(int rows, int cols);
+//copies the matrix into a contiguous row-major buffer, or its transpose if transposed is not 0
+int rowMajorToRowMajor(const Matrix *matrix, float *layout, int transposed);
+//copies a contiguous row-major buffer into the matrix
+int rowMajorFromBuffer(const float *layout, Matrix *matrix);
+//transposes the contiguous row-major buffer with the AVX2 kernel of libtranspose (the reference)
+void transposeRowMajor(const float *layout, float *transpose, int rows, int cols);
+//transposes the Morton layout, with the signature of the other layouts (the matrix is square)
+void transposeMortonLayout(const float *layout, float *transpose, int rows, int cols);
+//returns the average time (in seconds) of the transposition in the layout, and in conversion_time and
+//transposed_conversion_time those of the conversion from row-major of the matrix and of its transpose. The
+//last transpose is brought back to row-major in T and checked
+double averageLayoutTime(const Layout *layout, Matrix *M, Matrix *T, float *L, float *LT, int total_iterations,
+                         double *conversion_time, double *transposed_conversion_time);
+
+// The first one is the reference of the speedups
+static const Layout layouts[] = {
+    {"rowmajor", "row-major (16x16 AVX2 blocks, 32x32 tiles)", rowMajorSupported, rowMajorToRowMajor, rowMajorFromBuffer, transposeRowMajor},
+    {"tiled", "tiled (8x8 tiles in row-major order)", tiledLayoutSupported, rowMajorToTiled, tiledToRowMajor, transposeTiled},
+    {"morton", "Morton (8x8 tiles in Z-order)", mortonLayoutSupported, rowMajorToMorton, mortonToRowMajor, transposeMortonLayout},
+};
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (option: -layout rowmajor|tiled|morton).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the layout, if any, from the options (all of them one after the other otherwise)
+    const char *layout_name = NULL;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-layout") == 0 && a + 1 < argc) {
+            layout_name = argv[++a];
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Allocating memory for the matrices M and T and for the two of them in the layouts (one contiguous aligned block each)
+    Matrix M, T;
+    float *L = allocAligned((size_t)rows * cols * sizeof(float));
+    float *LT = allocAligned((size_t)rows * cols * sizeof(float));
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows) || L == NULL || LT == NULL) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double conversion_time, transposed_conversion_time;
+
+    //The row-major transposition is always timed, as the reference of the speedups
+    double reference_time = averageLayoutTime(&layouts[0], &M, &T, L, LT, total_iterations, &conversion_time, &transposed_conversion_time);
+    int found = 0;
+
+    for (int l = 0; l < (int)(sizeof(layouts) / sizeof(layouts[0])); l++) {
+        const Layout *layout = &layouts[l];
+        if (layout_name != NULL && strcmp(layout_name, layout->name) != 0) {
+            continue;
+        }
+        found = 1;
+        if (!layout->supported(rows, cols)) {
+            printf("Matrix size: %d x %d. Layout: %s. Not supported for this size.\n", rows, cols, layout->description);
+            continue;
+        }
+
+        double avg_time = (l == 0) ? reference_time : averageLayoutTime(layout, &M, &T, L, LT, total_iterations, &conversion_time, &transposed_conversion_time);
+        printf("Matrix size: %d x %d. Layout: %s. Average time taken: %.3fms. Speedup over row-major: %.2fx. Conversion from row-major: %.3fms. Conversion of the transpose: %.3fms\n", rows, cols, layout->description, avg_time / 1e-3, reference_time / avg_time, conversion_time / 1e-3, transposed_conversion_time / 1e-3);
+    }
+
+    if (!found) {
+        printf("The layout %s is unknown.\n", layout_name);
+        return 1;
+    }
+
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+    freeAligned(L);
+    freeAligned(LT);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int rowMajorSupported(int rows, int cols) {
+    return rows > 0 && cols > 0;
+}
+
+int rowMajorToRowMajor(const Matrix *matrix, float *layout, int transposed) {
+    if (transposed) {
+        Matrix transpose = {layout, matrix->cols, matrix->rows, matrix->rows, MATRIX_PAGES_DEFAULT};
+        matTransposeAVX2(matrix, &transpose);
+    } else {
+        for (int i = 0; i < matrix->rows; i++) {
+            memcpy(layout + (size_t)i * matrix->cols, matrixRow(matrix, i), matrix->cols * sizeof(float));
+        }
+    }
+    return 1;
+}
+
+int rowMajorFromBuffer(const float *layout, Matrix *matrix) {
+    for (int i = 0; i < matrix->rows; i++) {
+        memcpy(matrixRow(matrix, i), layout + (size_t)i * matrix->cols, matrix->cols * sizeof(float));
+    }
+    return 1;
+}
+
+void transposeRowMajor(const float *layout, float *transpose, int rows, int cols) {
+    const Matrix matrix = {(float *)layout, rows, cols, cols, MATRIX_PAGES_DEFAULT};
+    Matrix result = {transpose, cols, rows, rows, MATRIX_PAGES_DEFAULT};
+    matTransposeAVX2(&matrix, &result);
+}
+
+void transposeMortonLayout(const float *layout, float *transpose, int rows, int cols) {
+    // the Morton layout is only defined for square matrices (mortonLayoutSupported), so cols is rows
+    (void)cols;
+    transposeMorton(layout, transpose, rows);
+}
+
+double averageLayoutTime(const Layout *layout, Matrix *M, Matrix *T, float *L, float *LT, int total_iterations,
+                         double *conversion_time, double *transposed_conversion_time) {
+    double total_time = 0.0;
+    *conversion_time = 0.0;
+    *transposed_conversion_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+
+        // Converting the row-major matrix into the layout, as a caller would do once before working on it
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        layout->fromRowMajor(M, L, 0);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        *conversion_time += seconds + microseconds * 1e-6;
+
+        // Transposing the matrix without leaving the layout
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        layout->transpose(L, LT, M->rows, M->cols);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        total_time += seconds + microseconds * 1e-6;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed, once brought back to row-major
+        // printf("Matrix's actually transposed: %s\n", (layout->toRowMajor(LT, T) && matrix_actually_transposed(M, T)) ? "YES" : "NO");
+
+        // Converting the row-major matrix straight into its transpose in the layout (each tile transposed on the way)
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        layout->fromRowMajor(M, LT, 1);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        *transposed_conversion_time += seconds + microseconds * 1e-6;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the transpose converted directly is right as well
+        // printf("Matrix's actually transposed: %s\n", (layout->toRowMajor(LT, T) && matrix_actually_transposed(M, T)) ? "YES" : "NO");
+    }
+
+    // The last transpose brought back to row-major in T and checked once, outside the timings
+    if (!layout->toRowMajor(LT, T) || !matrix_actually_transposed(M, T)) {
+        printf("The %s layout gives a wrong transpose!\n", layout->name);
+    }
+
+    *conversion_time /= total_iterations;
+    *transposed_conversion_time /= total_iterations;
+    return total_time / total_iterations;
+}
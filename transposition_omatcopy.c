@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "transpose.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//transposes the sub_rows x sub_cols submatrix of M at (row, col) into T at (col, row), scaled by alpha, in place in the big buffers
+void transposeSubmatrix(const Matrix *M, Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha);
+//same result, the way it was done before somatcopy: the submatrix is copied out into its own matrix, transposed, and copied back
+void transposeSubmatrixCopying(const Matrix *M, Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha);
+//returns the average time (in seconds) of one of the two submatrix transpositions
+double averageSubmatrixTime(Matrix *M, Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha,
+                            void (*transpose)(const Matrix *, Matrix *, int, int, int, int, float), int total_iterations);
+//checks if the submatrix is actually transposed and scaled, and that nothing outside of it was written
+int submatrix_actually_transposed(const Matrix *M, const Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -sub <rows>x<cols>, -alpha <value>).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the submatrix size and the scale from the options: by default the central half of M, not scaled
+    int sub_rows = (rows / 2 > 0) ? rows / 2 : 1;
+    int sub_cols = (cols / 2 > 0) ? cols / 2 : 1;
+    float alpha = 1.0f;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-sub") == 0 && a + 1 < argc) {
+            if (!parseMatrixSize(argv[++a], &sub_rows, &sub_cols) || sub_rows > rows || sub_cols > cols) {
+                printf("The submatrix size must fit in the matrix.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-alpha") == 0 && a + 1 < argc) {
+            alpha = (float)atof(argv[++a]);
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+    int row = (rows - sub_rows) / 2;
+    int col = (cols - sub_cols) / 2;
+
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+
+    double strided_time = averageSubmatrixTime(&M, &T, row, col, sub_rows, sub_cols, alpha, transposeSubmatrix, total_iterations);
+    double copying_time = averageSubmatrixTime(&M, &T, row, col, sub_rows, sub_cols, alpha, transposeSubmatrixCopying, total_iterations);
+
+    printf("Matrix size: %d x %d. Submatrix: %d x %d at (%d, %d). Alpha: %g. Strided somatcopy: %.3fms. Copy, transpose and copy back: %.3fms\n", rows, cols, sub_rows, sub_cols, row, col, alpha, strided_time / 1e-3, copying_time / 1e-3);
+
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+void transposeSubmatrix(const Matrix *M, Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha) {
+    // The submatrices are addressed through their first element and the leading dimension of the whole buffers
+    somatcopy('T', sub_rows, sub_cols, alpha, &MAT(M, row, col), M->ld, &MAT(T, col, row), T->ld);
+}
+
+void transposeSubmatrixCopying(const Matrix *M, Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha) {
+    Matrix S, ST;
+    if (!allocMatrix(&S, sub_rows, sub_cols) || !allocMatrix(&ST, sub_cols, sub_rows)) {
+        printf("Unable to allocate the submatrices.\n");
+        exit(1);
+    }
+
+    for (int i = 0; i < sub_rows; i++) {
+        memcpy(matrixRow(&S, i), &MAT(M, row + i, col), sub_cols * sizeof(float));
+    }
+    somatcopy('T', sub_rows, sub_cols, alpha, S.data, S.ld, ST.data, ST.ld);
+    for (int j = 0; j < sub_cols; j++) {
+        memcpy(&MAT(T, col + j, row), matrixRow(&ST, j), sub_rows * sizeof(float));
+    }
+
+    freeMatrix(&S);
+    freeMatrix(&ST);
+}
+
+double averageSubmatrixTime(Matrix *M, Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha,
+                            void (*transpose)(const Matrix *, Matrix *, int, int, int, int, float), int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix, and T to zero so that writes outside the submatrix show up
+        initializeMatrix(M);
+        memset(T->data, 0, (size_t)T->rows * T->ld * sizeof(float));
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the submatrix
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        transpose(M, T, row, col, sub_rows, sub_cols, alpha);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the submatrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", submatrix_actually_transposed(M, T, row, col, sub_rows, sub_cols, alpha) ? "YES" : "NO");
+    }
+
+    return total_time / total_iterations;
+}
+
+int submatrix_actually_transposed(const Matrix *M, const Matrix *T, int row, int col, int sub_rows, int sub_cols, float alpha) {
+    for (int j = 0; j < T->rows; j++) {
+        for (int i = 0; i < T->cols; i++) {
+            int inside = (j >= col && j < col + sub_cols && i >= row && i < row + sub_rows);
+            float expected = inside ? alpha * MAT(M, i, j) : 0.0f;
+            if (MAT(T, j, i) != expected) {
+                return 0;
+            }
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,173 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <omp.h>
+#include "transpose.h"
+#include "planner.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//returns the average time (in seconds) of the transposition with the plan, or with matTransposeAuto if plan is NULL
+double averagePlanTime(const TransposePlan *plan, Matrix *M, Matrix *T, int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -threads <max threads>, -pad auto|<floats>, -estimate, -wisdom <file>, -forget).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the options: the most threads the plan may use (all of them by default), the padding of the rows, the planning
+    //mode, the wisdom file that keeps the plans from one run to the next and whether its plans for this size are dropped
+    int max_threads = omp_get_max_threads();
+    int padding = 0;
+    int flags = PLAN_MEASURE;
+    const char *wisdom_file = NULL;
+    int forget = 0;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-threads") == 0 && a + 1 < argc) {
+            max_threads = atoi(argv[++a]);
+            if (max_threads < 1) {
+                printf("The number of threads must be at least 1.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-pad") == 0 && a + 1 < argc) {
+            padding = parsePadding(argv[++a]);
+            if (padding < 0) {
+                printf("The padding must be auto or a number of floats.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-estimate") == 0) {
+            flags = PLAN_ESTIMATE;
+        } else if (strcmp(argv[a], "-wisdom") == 0 && a + 1 < argc) {
+            wisdom_file = argv[++a];
+        } else if (strcmp(argv[a], "-forget") == 0) {
+            forget = 1;
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Allocating memory for the matrices M and T (one contiguous aligned block each, rows padded if asked)
+    Matrix M, T;
+    if (!allocMatrixPadded(&M, rows, cols, cols + padding) || !allocMatrixPadded(&T, cols, rows, rows + padding)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
+    }
+
+    //Loading the plans of the previous runs (the file does not exist before the first one)
+    if (wisdom_file != NULL) {
+        importTransposeWisdom(wisdom_file);
+        if (forget) {
+            invalidateTransposeWisdom(rows, cols);
+        }
+    }
+
+    //Planning once for this size and these leading dimensions
+    struct timeval start, end;
+    #ifdef _WIN32
+        mingw_gettimeofday(&start, NULL);
+    #else
+        gettimeofday(&start, NULL);
+    #endif
+    TransposePlan *plan = planTranspose(rows, cols, M.ld, T.ld, max_threads, flags);
+    #ifdef _WIN32
+        mingw_gettimeofday(&end, NULL);
+    #else
+        gettimeofday(&end, NULL);
+    #endif
+    if (plan == NULL) {
+        printf("Unable to plan the transposition.\n");
+        return 1;
+    }
+    double planning_time = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) * 1e-6;
+
+    //Saving the wisdom with the plan just measured, for the next runs
+    if (wisdom_file != NULL && !exportTransposeWisdom(wisdom_file)) {
+        printf("Unable to write the wisdom to %s.\n", wisdom_file);
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double plan_time = averagePlanTime(plan, &M, &T, total_iterations);
+    double auto_time = averagePlanTime(NULL, &M, &T, total_iterations);
+
+    printf("Matrix size: %d x %d. Padding: %d. Plan: %s, tile %d, %d threads, %s schedule%s. Planning time: %.3fms. Average time taken: %.3fms. matTransposeAuto: %.3fms. Speedup: %.2fx\n", rows, cols, padding, plan->path->description, plan->tile, plan->threads, planScheduleName(plan->schedule), plan->wisdom ? " (from wisdom)" : "", planning_time / 1e-3, plan_time / 1e-3, auto_time / 1e-3, auto_time / plan_time);
+
+    //Freeing memory
+    destroyTransposePlan(plan);
+    freeMatrix(&M);
+    freeMatrix(&T);
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averagePlanTime(const TransposePlan *plan, Matrix *M, Matrix *T, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix with the plan (no choice left to make) or choosing the kernel from the CPU
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        if (plan != NULL) {
+            executeTransposePlan(plan, M, T);
+        } else {
+            matTransposeAuto(M, T);
+        }
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T) ? "YES" : "NO");
+    }
+
+    return total_time / total_iterations;
+}
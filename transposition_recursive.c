@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "transpose.h"
+#include "simd_kernels.h"
+
+// Largest side of a block transposed without splitting it further: a 32x32 source block
+// and its 32x32 destination take 8KB, so they fit in the L1 of any recent CPU
+#define RECURSION_LEAF 32
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//transposes the matrix
+void matTranspose(const Matrix *matrix, Matrix *transpose);
+//transposes the block [row_start, row_end) x [col_start, col_end) splitting it recursively
+void transposeRecursive(const Matrix *matrix, Matrix *transpose, int row_start, int row_end, int col_start, int col_end);
+//transposes a block small enough to stay in L1 using the 8x8 AVX kernel (masked at the edges of the matrix)
+void transposeLeaf(const Matrix *matrix, Matrix *transpose, int row_start, int row_end, int col_start, int col_end);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc != 2) {
+        printf("Please add a matrix size as an argument.\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(&M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        matTranspose(&M, &T);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(&M, &T) ? "YES" : "NO");
+
+        // printf("Original Matrix:\n");
+        // printMatrix(&M);
+
+        // printf("Transposed Matrix:\n");
+        // printMatrix(&T);
+    }
+
+    double avg_time = total_time / total_iterations;
+    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", rows, cols, avg_time / 1e-3);
+    
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+    
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+void matTranspose(const Matrix *matrix, Matrix *transpose) {
+    transposeRecursive(matrix, transpose, 0, matrix->rows, 0, matrix->cols);
+}
+
+void transposeRecursive(const Matrix *matrix, Matrix *transpose, int row_start, int row_end, int col_start, int col_end) {
+    int rows = row_end - row_start;
+    int cols = col_end - col_start;
+
+    if (rows <= RECURSION_LEAF && cols <= RECURSION_LEAF) {
+        transposeLeaf(matrix, transpose, row_start, row_end, col_start, col_end);
+        return;
+    }
+
+    // Split the larger dimension in two. The cut is rounded to a multiple of 8
+    // so that the leaves are made of whole 8x8 blocks whenever the matrix allows it.
+    if (rows >= cols) {
+        int row_mid = row_start + (((rows / 2) + 7) & ~7);
+        transposeRecursive(matrix, transpose, row_start, row_mid, col_start, col_end);
+        transposeRecursive(matrix, transpose, row_mid, row_end, col_start, col_end);
+    } else {
+        int col_mid = col_start + (((cols / 2) + 7) & ~7);
+        transposeRecursive(matrix, transpose, row_start, row_end, col_start, col_mid);
+        transposeRecursive(matrix, transpose, row_start, row_end, col_mid, col_end);
+    }
+}
+
+void transposeLeaf(const Matrix *matrix, Matrix *transpose, int row_start, int row_end, int col_start, int col_end) {
+    const int blockSize = 8;
+
+    // Whole 8x8 blocks go through the AVX shuffle network, the ones cut by the
+    // edge of the matrix through the same network with masked loads and stores
+    for (int i = row_start; i < row_end; i += blockSize) {
+        int block_rows = (row_end - i < blockSize) ? row_end - i : blockSize;
+        for (int j = col_start; j < col_end; j += blockSize) {
+            int block_cols = (col_end - j < blockSize) ? col_end - j : blockSize;
+            if (block_rows == blockSize && block_cols == blockSize) {
+                transposeBlock8x8(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld);
+            } else {
+                transposeBlockPartial8x8(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, block_rows, block_cols);
+            }
+        }
+    }
+}
@@ -6,20 +6,15 @@
 #include <sys/time.h>
 #endif
 #include <time.h>
+#include "transpose.h"
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values
-void initializeMatrix(float **matrix, int n);
 //transposes the matrix
-void matTranspose(float **matrix, float **transpose, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
-//checks if the matrix is actually transposed
-int matrix_actually_transposed(float **matrix, float **transpose, int n);
+void matTranspose(const Matrix *matrix, Matrix *transpose);
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
@@ -32,22 +27,18 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
-
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    float **T = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
-        T[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
     }
 
     //Set the number of iterations to get a better average time
@@ -56,7 +47,7 @@ int main(int argc, char *argv[]) {
 
     for(int i = 0; i < total_iterations; i++) {
         // Initializing the completely casual matrix
-        initializeMatrix(M, matrix_size);
+        initializeMatrix(&M);
 
         // Structure to store the time
         struct timeval start, end;
@@ -70,7 +61,7 @@ int main(int argc, char *argv[]) {
             gettimeofday(&start, NULL);
         #endif
 
-        matTranspose(M, T, matrix_size);
+        matTranspose(&M, &T);
         
         #ifdef _WIN32
             mingw_gettimeofday(&end, NULL);
@@ -86,26 +77,21 @@ int main(int argc, char *argv[]) {
 
         //CHECK SECTION - Uncomment to check the matrices
         // Check whether the matrix is actually transposed
-        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T, matrix_size) ? "YES" : "NO");
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(&M, &T) ? "YES" : "NO");
 
         // printf("Original Matrix:\n");
-        // printMatrix(M, matrix_size);
+        // printMatrix(&M);
 
         // printf("Transposed Matrix:\n");
-        // printMatrix(T, matrix_size);
+        // printMatrix(&T);
     }
 
     double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", matrix_size, matrix_size, avg_time / 1e-3);
+    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", rows, cols, avg_time / 1e-3);
 
     //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-        free(T[i]);
-    }
-
-    free(M);
-    free(T);
+    freeMatrix(&M);
+    freeMatrix(&T);
     
     return 0;
 }
@@ -115,38 +101,10 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-void initializeMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (float)rand();
-        }
-    }
-}
-
-void matTranspose(float **matrix, float **transpose, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            transpose[j][i] = matrix[i][j];
+void matTranspose(const Matrix *matrix, Matrix *transpose) {
+    for (int i = 0; i < matrix->rows; i++) {
+        for (int j = 0; j < matrix->cols; j++) {
+            MAT(transpose, j, i) = MAT(matrix, i, j);
         }
     }
 }
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-int matrix_actually_transposed(float **matrix, float **transpose, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != transpose[j][i]) {
-                return 0;
-            }
-        }
-    }
-    return 1;
-}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <complex.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "matrix.h"
+#include "typed_kernels.h"
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// One element type with the functions that work on its matrices (rows x cols, no padding)
+typedef struct {
+    const char *name;
+    const char *description;
+    size_t size;
+    void (*initialize)(void *matrix, int rows, int cols);
+    void (*transpose)(const void *matrix, void *transpose, int rows, int cols);
+    int (*actuallyTransposed)(const void *matrix, const void *transpose, int rows, int cols);
+} ElementType;
+
+// Defines, for one element type, the random initialization, the call of its transposition and the check
+#define DEFINE_ELEMENT_TYPE_FUNCTIONS(NAME, TYPE, RANDOM) \
+void initializeMatrix##NAME(void *matrix, int rows, int cols) { \
+    TYPE *m = (TYPE *)matrix; \
+    for (size_t k = 0; k < (size_t)rows * cols; k++) { \
+        m[k] = RANDOM; \
+    } \
+} \
+void transpose##NAME(const void *matrix, void *transpose, int rows, int cols) { \
+    matTranspose##NAME((const TYPE *)matrix, cols, (TYPE *)transpose, rows, rows, cols); \
+} \
+int actuallyTransposed##NAME(const void *matrix, const void *transpose, int rows, int cols) { \
+    const TYPE *m = (const TYPE *)matrix; \
+    const TYPE *t = (const TYPE *)transpose; \
+    for (int i = 0; i < rows; i++) { \
+        for (int j = 0; j < cols; j++) { \
+            if (m[(size_t)i * cols + j] != t[(size_t)j * rows + i]) { \
+                return 0; \
+            } \
+        } \
+    } \
+    return 1; \
+}
+
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Float, float, (float)rand())
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Double, double, (double)rand())
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Complex, complex_float, (float)rand() + (float)rand() * I)
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Int16, int16_t, (int16_t)rand())
+DEFINE_ELEMENT_TYPE_FUNCTIONS(Int8, int8_t, (int8_t)rand())
+
+static const ElementType element_types[] = {
+    {"float", "float (8x8 AVX2 blocks)", sizeof(float), initializeMatrixFloat, transposeFloat, actuallyTransposedFloat},
+    {"double", "double (4x4 AVX2 blocks)", sizeof(double), initializeMatrixDouble, transposeDouble, actuallyTransposedDouble},
+    {"complex", "complex float (4x4 AVX2 blocks)", sizeof(complex_float), initializeMatrixComplex, transposeComplex, actuallyTransposedComplex},
+    {"int16", "int16 (16x16 AVX2 blocks)", sizeof(int16_t), initializeMatrixInt16, transposeInt16, actuallyTransposedInt16},
+    {"int8", "int8 (16x16 SSE2 blocks)", sizeof(int8_t), initializeMatrixInt8, transposeInt8, actuallyTransposedInt8},
+};
+
+//returns the average time (in seconds) of the transposition of a rows x cols matrix of the given type
+double averageTransposeTime(const ElementType *type, void *M, void *T, int rows, int cols, int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (option: -type float|double|complex|int16|int8).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the element type, if any, from the options (all of them one after the other otherwise)
+    const char *type_name = NULL;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-type") == 0 && a + 1 < argc) {
+            type_name = argv[++a];
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+
+    //Set the number of iterations to get a better average time
+    int total_iterations = 50;
+    int found = 0;
+
+    for (int t = 0; t < (int)(sizeof(element_types) / sizeof(element_types[0])); t++) {
+        const ElementType *type = &element_types[t];
+        if (type_name != NULL && strcmp(type_name, type->name) != 0) {
+            continue;
+        }
+        found = 1;
+
+        //Allocating memory for the matrices M and T (one contiguous aligned block each)
+        void *M = allocAligned((size_t)rows * cols * type->size);
+        void *T = allocAligned((size_t)rows * cols * type->size);
+        if (M == NULL || T == NULL) {
+            printf("Unable to allocate the matrices.\n");
+            return 1;
+        }
+
+        double avg_time = averageTransposeTime(type, M, T, rows, cols, total_iterations);
+        printf("Matrix size: %d x %d. Element type: %s. Average time taken: %.3fms\n", rows, cols, type->description, avg_time / 1e-3);
+
+        //Freeing memory
+        freeAligned(M);
+        freeAligned(T);
+    }
+
+    if (!found) {
+        printf("The element type %s is unknown.\n", type_name);
+        return 1;
+    }
+
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageTransposeTime(const ElementType *type, void *M, void *T, int rows, int cols, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        type->initialize(M, rows, cols);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        type->transpose(M, T, rows, cols);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", type->actuallyTransposed(M, T, rows, cols) ? "YES" : "NO");
+    }
+
+    return total_time / total_iterations;
+}
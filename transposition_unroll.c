@@ -6,20 +6,15 @@
 #include <sys/time.h>
 #endif
 #include <time.h>
+#include "transpose.h"
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values
-void initializeMatrix(float **matrix, int n);
 //transposes the matrix (CHANGE THE LEVEL OF UNROLLING IN THIS FUNCTION DEFINITION)
-void matTranspose(float **matrix, float **transpose, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
-//checks if the matrix is actually transposed
-int matrix_actually_transposed(float **matrix, float **transpose, int n);
+void matTranspose(const Matrix *matrix, Matrix *transpose);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -33,22 +28,18 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
-
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    float **T = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
-        T[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
     }
 
     //Set the number of iterations to get a better average time
@@ -57,7 +48,7 @@ int main(int argc, char *argv[]) {
 
     for(int i = 0; i < total_iterations; i++) {
         // Initializing the completely casual matrix
-        initializeMatrix(M, matrix_size);
+        initializeMatrix(&M);
 
         // Structure to store the time
         struct timeval start, end;
@@ -71,7 +62,7 @@ int main(int argc, char *argv[]) {
             gettimeofday(&start, NULL);
         #endif
 
-        matTranspose(M, T, matrix_size);
+        matTranspose(&M, &T);
         
         #ifdef _WIN32
             mingw_gettimeofday(&end, NULL);
@@ -87,26 +78,21 @@ int main(int argc, char *argv[]) {
 
         //CHECK SECTION - Uncomment to check the matrices
         // Check whether the matrix is actually transposed
-        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T, matrix_size) ? "YES" : "NO");
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(&M, &T) ? "YES" : "NO");
 
         // printf("Original Matrix:\n");
-        // printMatrix(M, matrix_size);
+        // printMatrix(&M);
 
         // printf("Transposed Matrix:\n");
-        // printMatrix(T, matrix_size);
+        // printMatrix(&T);
     }
 
     double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", matrix_size, matrix_size, avg_time / 1e-3);
+    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", rows, cols, avg_time / 1e-3);
 
     //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-        free(T[i]);
-    }
-
-    free(M);
-    free(T);
+    freeMatrix(&M);
+    freeMatrix(&T);
     
     return 0;
 }
@@ -116,55 +102,27 @@ int main(int argc, char *argv[]) {
 // %%%%%% FUNCTIONS DEFINITION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-void initializeMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (float)rand();
-        }
-    }
-}
-
-void matTranspose(float **matrix, float **transpose, int n) {
+void matTranspose(const Matrix *matrix, Matrix *transpose) {
     // !!!!! CRITICAL IN ORDER TO EXECUTE DIFFERENT BLOCK SIZES -> Comment or Uncomment the lines below to change the block size !!!!!
 
     int blockSize = 2; 
     // int blockSize = 4; 
     // int blockSize = 8;
     
-    for (int i = 0; i < n; i += 1) {
+    for (int i = 0; i < matrix->rows; i += 1) {
         int j;
-        for (j = 0; j < n - blockSize + 1; j += blockSize) {
-            transpose[j][i] = matrix[i][j];
-            transpose[j + 1][i] = matrix[i][j + 1];
-            // transpose[j + 2][i] = matrix[i][j + 2];
-            // transpose[j + 3][i] = matrix[i][j + 3];
-            // transpose[j + 4][i] = matrix[i][j + 4];
-            // transpose[j + 5][i] = matrix[i][j + 5];
-            // transpose[j + 6][i] = matrix[i][j + 6];
-            // transpose[j + 7][i] = matrix[i][j + 7];
+        for (j = 0; j < matrix->cols - blockSize + 1; j += blockSize) {
+            MAT(transpose, j, i) = MAT(matrix, i, j);
+            MAT(transpose, j + 1, i) = MAT(matrix, i, j + 1);
+            // MAT(transpose, j + 2, i) = MAT(matrix, i, j + 2);
+            // MAT(transpose, j + 3, i) = MAT(matrix, i, j + 3);
+            // MAT(transpose, j + 4, i) = MAT(matrix, i, j + 4);
+            // MAT(transpose, j + 5, i) = MAT(matrix, i, j + 5);
+            // MAT(transpose, j + 6, i) = MAT(matrix, i, j + 6);
+            // MAT(transpose, j + 7, i) = MAT(matrix, i, j + 7);
         }
-        for (; j < n; j++) {
-            transpose[j][i] = matrix[i][j];
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-int matrix_actually_transposed(float **matrix, float **transpose, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != transpose[j][i]) {
-                return 0;
-            }
+        for (; j < matrix->cols; j++) {
+            MAT(transpose, j, i) = MAT(matrix, i, j);
         }
     }
-    return 1;
 }
@@ -0,0 +1,236 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+#include <time.h>
+#include <immintrin.h>
+#include "transpose.h"
+#include "simd_kernels.h"
+
+#ifndef __AVX512F__
+#error "transposition_vectorization_16.c needs the AVX-512 kernels: compile it with -mavx512f"
+#endif
+
+// Side of the register-level block
+#define BLOCK_SIZE 16
+// Default tile sides (in elements) for the two cache levels. On the Xeon Gold 6252N (32KB L1d, 1MB L2)
+// a 32x32 source tile plus its destination take 8KB of L1 (4 register blocks of 16x16) and a 256x256 pair takes 512KB of L2.
+#define DEFAULT_L1_TILE 32
+#define DEFAULT_L2_TILE 256
+// Number of iterations averaged for every tile pair in sweep mode
+#define SWEEP_ITERATIONS 10
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%% FUNCTIONS DECLARATION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+//transposes the matrix visiting L2 tiles, then L1 tiles inside them, then register blocks
+void matTranspose(const Matrix *matrix, Matrix *transpose, int l2_tile, int l1_tile);
+//returns the average time (in seconds) of the transposition with the given tile sizes
+double averageTransposeTime(Matrix *M, Matrix *T, int l2_tile, int l1_tile, int total_iterations);
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% MAIN FUNCTION %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+int main(int argc, char *argv[]) {
+    //Checking the number of arguments
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -l2 <tile> -l1 <tile>, -pad auto|<floats>, -huge or -sweep).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the tile sizes (or the sweep request) from the options
+    int l2_tile = DEFAULT_L2_TILE;
+    int l1_tile = DEFAULT_L1_TILE;
+    int sweep = 0;
+    int padding = 0;
+    int huge_pages = 0;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-l2") == 0 && a + 1 < argc) {
+            l2_tile = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-l1") == 0 && a + 1 < argc) {
+            l1_tile = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-pad") == 0 && a + 1 < argc) {
+            padding = parsePadding(argv[++a]);
+            if (padding < 0) {
+                printf("The padding must be auto or a number of floats between 0 and 4096.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-huge") == 0) {
+            huge_pages = 1;
+        } else if (strcmp(argv[a], "-sweep") == 0) {
+            sweep = 1;
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+    if (l1_tile <= 0 || l2_tile <= 0 || l1_tile % BLOCK_SIZE != 0 || l2_tile % l1_tile != 0) {
+        printf("Tile sizes must be multiples of %d and the L2 tile must be a multiple of the L1 tile.\n", BLOCK_SIZE);
+        return 1;
+    }
+
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
+    }
+
+    if (sweep) {
+        //Trying every pair of power of two tiles that fits in the matrix and keeping the fastest one
+        int best_l2 = 0, best_l1 = 0;
+        double best_time = 0.0;
+        for (int l2 = BLOCK_SIZE; l2 < 2 * rows || l2 < 2 * cols; l2 *= 2) {
+            for (int l1 = BLOCK_SIZE; l1 <= l2; l1 *= 2) {
+                double avg_time = averageTransposeTime(&M, &T, l2, l1, SWEEP_ITERATIONS);
+                printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, l2, l1, avg_time / 1e-3);
+                if (best_l2 == 0 || avg_time < best_time) {
+                    best_l2 = l2;
+                    best_l1 = l1;
+                    best_time = avg_time;
+                }
+            }
+        }
+        printf("Best tiles for %d x %d: L2 tile %d, L1 tile %d. Average time taken: %.3fms\n", rows, cols, best_l2, best_l1, best_time / 1e-3);
+    } else {
+        //Set the number of iterations to get a better average time
+        int total_iterations = 50;
+        double avg_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, total_iterations);
+        printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, l2_tile, l1_tile, avg_time / 1e-3);
+
+        //Running the same transposition with padded rows right after, so the two layouts can be compared side by side
+        double reference_time = avg_time;
+        if (padding > 0) {
+            Matrix PM, PT;
+            if (!allocMatrixPadded(&PM, rows, cols, cols + padding) || !allocMatrixPadded(&PT, cols, rows, rows + padding)) {
+                printf("Unable to allocate the padded matrices.\n");
+                return 1;
+            }
+            double padded_time = averageTransposeTime(&PM, &PT, l2_tile, l1_tile, total_iterations);
+            printf("Matrix size: %d x %d. Padded leading dimensions: %d and %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, PM.ld, PT.ld, l2_tile, l1_tile, padded_time / 1e-3);
+            freeMatrix(&PM);
+            freeMatrix(&PT);
+            reference_time = padded_time;
+        }
+
+        //Running the same transposition (same padding) on buffers backed by 2MB pages: a 4096 x 4096 matrix
+        //spans 16384 4KB pages but only 32 huge ones, so the column walk of T stops missing in the TLB
+        if (huge_pages) {
+            Matrix HM, HT;
+            if (!allocMatrixHugePages(&HM, rows, cols, cols + padding) || !allocMatrixHugePages(&HT, cols, rows, rows + padding)) {
+                printf("Unable to allocate the huge page matrices.\n");
+                return 1;
+            }
+            double huge_time = averageTransposeTime(&HM, &HT, l2_tile, l1_tile, total_iterations);
+            printf("Matrix size: %d x %d. Pages: %s and %s. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, matrixPagesName(&HM), matrixPagesName(&HT), l2_tile, l1_tile, huge_time / 1e-3, reference_time / huge_time);
+            freeMatrix(&HM);
+            freeMatrix(&HT);
+        }
+    }
+    
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+    
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageTransposeTime(Matrix *M, Matrix *T, int l2_tile, int l1_tile, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        matTranspose(M, T, l2_tile, l1_tile);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
+
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T) ? "YES" : "NO");
+
+        // printf("Original Matrix:\n");
+        // printMatrix(M);
+
+        // printf("Transposed Matrix:\n");
+        // printMatrix(T);
+    }
+
+    return total_time / total_iterations;
+}
+
+void matTranspose(const Matrix *matrix, Matrix *transpose, int l2_tile, int l1_tile) {
+    const int blockSize = BLOCK_SIZE;
+    int rows = matrix->rows;
+    int cols = matrix->cols;
+
+    // Outer level: tiles sized for L2
+    for (int i2 = 0; i2 < rows; i2 += l2_tile) {
+        int i2_end = (i2 + l2_tile < rows) ? i2 + l2_tile : rows;
+        for (int j2 = 0; j2 < cols; j2 += l2_tile) {
+            int j2_end = (j2 + l2_tile < cols) ? j2 + l2_tile : cols;
+
+            // Middle level: tiles sized for L1 inside the current L2 tile
+            for (int i1 = i2; i1 < i2_end; i1 += l1_tile) {
+                int i1_end = (i1 + l1_tile < i2_end) ? i1 + l1_tile : i2_end;
+                for (int j1 = j2; j1 < j2_end; j1 += l1_tile) {
+                    int j1_end = (j1 + l1_tile < j2_end) ? j1 + l1_tile : j2_end;
+
+                    // Register level: 16x16 blocks transposed in the 32 AVX-512 registers
+                    for (int i = i1; i < i1_end; i += blockSize) {
+                        int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                        for (int j = j1; j < j1_end; j += blockSize) {
+                            int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                            if (block_rows == blockSize && block_cols == blockSize) {
+                                transposeBlock16x16(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld);
+                            } else {
+                                // remainder rows and columns at the edge of the matrix
+                                transposeBlockPartial16x16(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, block_rows, block_cols);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef _WIN32
 #include <windows.h>
 #else
@@ -7,22 +8,48 @@
 #endif
 #include <time.h>
 #include <immintrin.h>
+#include "transpose.h"
+#include "simd_kernels.h"
+
+// Side of the register-level block
+#define BLOCK_SIZE 4
+// Default tile sides (in elements) for the two cache levels. On the Xeon Gold 6252N (32KB L1d, 1MB L2)
+// a 32x32 source tile plus its destination take 8KB of L1 and a 256x256 pair takes 512KB of L2.
+#define DEFAULT_L1_TILE 32
+#define DEFAULT_L2_TILE 256
+// Number of iterations averaged for every tile pair in sweep mode
+#define SWEEP_ITERATIONS 10
+// Default prefetch distance (in elements): one L1 tile ahead, i.e. the same block of the next tile
+#define DEFAULT_PREFETCH_DISTANCE DEFAULT_L1_TILE
+
+// A register kernel of matTranspose: it transposes the full rows x cols blocks of src (rows lds floats apart)
+// into dst (rows ldd floats apart). distance is the prefetch distance of the kernels that prefetch, the
+// others ignore it
+typedef struct {
+    int rows, cols;
+    void (*transpose)(const float *src, int lds, float *dst, int ldd, int distance);
+} RegisterKernel;
+
+//transposeBlock4x4 with the signature of the register kernels (it prefetches nothing)
+static inline SIMD_TARGET_SSE void transposeBlockCached4x4(const float *src, int lds, float *dst, int ldd, int distance) {
+    (void)distance;
+    transposeBlock4x4(src, lds, dst, ldd);
+}
+
+// The plain kernel, and the one prefetching the block distance columns ahead
+static const RegisterKernel cached_kernel = {BLOCK_SIZE, BLOCK_SIZE, transposeBlockCached4x4};
+static const RegisterKernel prefetch_kernel = {BLOCK_SIZE, BLOCK_SIZE, transposeBlockPrefetch4x4};
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values
-void initializeMatrix(float **matrix, int n);
-//transposes the matrix
-void matTranspose(float **matrix, float **transpose, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
-//checks if the matrix is stored in row-major order
-int isRowMajor(float **matrix, int n);
-//checks if the matrix is actually transposed
-int matrix_actually_transposed(float **matrix, float **transpose, int n);
+//transposes the matrix visiting L2 tiles, then L1 tiles inside them, then the blocks of the register kernel
+//(distance is passed on to it)
+void matTranspose(const Matrix *matrix, Matrix *transpose, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance);
+//returns the average time (in seconds) of the transposition with the given tile sizes and register kernel
+double averageTransposeTime(Matrix *M, Matrix *T, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance, int total_iterations);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -31,42 +58,140 @@ int matrix_actually_transposed(float **matrix, float **transpose, int n);
 
 int main(int argc, char *argv[]) {
     //Checking the number of arguments
-    if (argc != 2) {
-        printf("Please add a matrix size as an argument.\n");
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -l2 <tile> -l1 <tile>, -pad auto|<floats>, -huge, -prefetch auto|<distance> or -sweep).\n");
+        return 1;
+    }
+
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
+        return 1;
+    }
+
+    //Reading the tile sizes (or the sweep request) from the options
+    int l2_tile = DEFAULT_L2_TILE;
+    int l1_tile = DEFAULT_L1_TILE;
+    int sweep = 0;
+    int padding = 0;
+    int huge_pages = 0;
+    int prefetch_distance = 0;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-l2") == 0 && a + 1 < argc) {
+            l2_tile = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-l1") == 0 && a + 1 < argc) {
+            l1_tile = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-pad") == 0 && a + 1 < argc) {
+            padding = parsePadding(argv[++a]);
+            if (padding < 0) {
+                printf("The padding must be auto or a number of floats between 0 and 4096.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-prefetch") == 0 && a + 1 < argc) {
+            a++;
+            prefetch_distance = (strcmp(argv[a], "auto") == 0) ? DEFAULT_PREFETCH_DISTANCE : atoi(argv[a]);
+            if (prefetch_distance <= 0) {
+                printf("The prefetch distance must be auto or a positive number of elements.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-huge") == 0) {
+            huge_pages = 1;
+        } else if (strcmp(argv[a], "-sweep") == 0) {
+            sweep = 1;
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+    if (l1_tile <= 0 || l2_tile <= 0 || l1_tile % BLOCK_SIZE != 0 || l2_tile % l1_tile != 0) {
+        printf("Tile sizes must be multiples of %d and the L2 tile must be a multiple of the L1 tile.\n", BLOCK_SIZE);
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
+    if (sweep) {
+        //Trying every pair of power of two tiles that fits in the matrix and keeping the fastest one
+        int best_l2 = 0, best_l1 = 0;
+        double best_time = 0.0;
+        for (int l2 = BLOCK_SIZE; l2 < 2 * rows || l2 < 2 * cols; l2 *= 2) {
+            for (int l1 = BLOCK_SIZE; l1 <= l2; l1 *= 2) {
+                double avg_time = averageTransposeTime(&M, &T, l2, l1, &cached_kernel, 0, SWEEP_ITERATIONS);
+                printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, l2, l1, avg_time / 1e-3);
+                if (best_l2 == 0 || avg_time < best_time) {
+                    best_l2 = l2;
+                    best_l1 = l1;
+                    best_time = avg_time;
+                }
+            }
+        }
+        printf("Best tiles for %d x %d: L2 tile %d, L1 tile %d. Average time taken: %.3fms\n", rows, cols, best_l2, best_l1, best_time / 1e-3);
+    } else {
+        //Set the number of iterations to get a better average time
+        int total_iterations = 50;
+        double avg_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, &cached_kernel, 0, total_iterations);
+        printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, l2_tile, l1_tile, avg_time / 1e-3);
+
+        //Running the same transposition with padded rows right after, so the two layouts can be compared side by side
+        double reference_time = avg_time;
+        if (padding > 0) {
+            Matrix PM, PT;
+            if (!allocMatrixPadded(&PM, rows, cols, cols + padding) || !allocMatrixPadded(&PT, cols, rows, rows + padding)) {
+                printf("Unable to allocate the padded matrices.\n");
+                return 1;
+            }
+            double padded_time = averageTransposeTime(&PM, &PT, l2_tile, l1_tile, &cached_kernel, 0, total_iterations);
+            printf("Matrix size: %d x %d. Padded leading dimensions: %d and %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, PM.ld, PT.ld, l2_tile, l1_tile, padded_time / 1e-3);
+            freeMatrix(&PM);
+            freeMatrix(&PT);
+            reference_time = padded_time;
+        }
+
+        //Running the same transposition (same padding) on buffers backed by 2MB pages: a 4096 x 4096 matrix
+        //spans 16384 4KB pages but only 32 huge ones, so the column walk of T stops missing in the TLB
+        if (huge_pages) {
+            Matrix HM, HT;
+            if (!allocMatrixHugePages(&HM, rows, cols, cols + padding) || !allocMatrixHugePages(&HT, cols, rows, rows + padding)) {
+                printf("Unable to allocate the huge page matrices.\n");
+                return 1;
+            }
+            double huge_time = averageTransposeTime(&HM, &HT, l2_tile, l1_tile, &cached_kernel, 0, total_iterations);
+            printf("Matrix size: %d x %d. Pages: %s and %s. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, matrixPagesName(&HM), matrixPagesName(&HT), l2_tile, l1_tile, huge_time / 1e-3, reference_time / huge_time);
+            freeMatrix(&HM);
+            freeMatrix(&HT);
+        }
 
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    float **T = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
-        T[i] = (float *)malloc(matrix_size * sizeof(float));
+        //Running the prefetching kernel right after, so that the two kernels can be compared side by side
+        if (prefetch_distance > 0) {
+            double prefetch_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, &prefetch_kernel, prefetch_distance, total_iterations);
+            printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Prefetch distance: %d. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, l2_tile, l1_tile, prefetch_distance, prefetch_time / 1e-3, avg_time / prefetch_time);
+        }
     }
+    
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+    
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-    //Set the number of iterations to get a better average time
-    int total_iterations = 50;
+double averageTransposeTime(Matrix *M, Matrix *T, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance, int total_iterations) {
     double total_time = 0.0;
 
     for(int i = 0; i < total_iterations; i++) {
         // Initializing the completely casual matrix
-        initializeMatrix(M, matrix_size);
-
-        // Check if the matrix is stored in row-major order
-        if (!isRowMajor(M, matrix_size)) {
-            printf("Matrix is not stored in row-major order.\n");
-            return 1;
-        }
+        initializeMatrix(M);
 
         // Structure to store the time
         struct timeval start, end;
@@ -79,114 +204,65 @@ int main(int argc, char *argv[]) {
         #else
             gettimeofday(&start, NULL);
         #endif
-
-        matTranspose(M, T, matrix_size);
+        matTranspose(M, T, l2_tile, l1_tile, kernel, distance);
         #ifdef _WIN32
-
             mingw_gettimeofday(&end, NULL);
         #else
             gettimeofday(&end, NULL);
         #endif
 
-        //Time elapsed calculation
         seconds = end.tv_sec - start.tv_sec;
         microseconds = end.tv_usec - start.tv_usec;
         time_taken = seconds + microseconds * 1e-6;
         total_time += time_taken;
-    }
-
-    double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", matrix_size, matrix_size, avg_time / 1e-3);
 
-    // printf("Original Matrix:\n");
-    // printMatrix(M, matrix_size);
+        //CHECK SECTION - Uncomment to check the matrices
+        // Check whether the matrix is actually transposed
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T) ? "YES" : "NO");
 
-    // printf("Transposed Matrix:\n");
-    // printMatrix(T, matrix_size);
+        // printf("Original Matrix:\n");
+        // printMatrix(M);
 
-
-    //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-        free(T[i]);
+        // printf("Transposed Matrix:\n");
+        // printMatrix(T);
     }
 
-    free(M);
-    free(T);
-    
-    return 0;
-}
-
-
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-// %%%%%% FUNCTIONS DEFINITION %%%%%% //
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-
-void initializeMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (float)rand();
-        }
-    }
-}
-
-void matTranspose(float** matrix, float** transpose, int n) {
-    const int blockSize = 4;
-    for (int i = 0; i < n; i += blockSize) {
-        for (int j = 0; j < n; j += blockSize) {
-            // loads 4 floats at time into row0, row1, row2, row3 --m128 registers
-            __m128 row0 = _mm_loadu_ps(&matrix[i][j]);  //row0 = (matrix[i][j], matrix[i][j+1], matrix[i][j+2], matrix[i][j+3])
-            __m128 row1 = _mm_loadu_ps(&matrix[i + 1][j]);
-            __m128 row2 = _mm_loadu_ps(&matrix[i + 2][j]);
-            __m128 row3 = _mm_loadu_ps(&matrix[i + 3][j]);
-
-            // Rearrange the rows, by interleaving the inputs lower and higher parts
-            __m128 tmp0 = _mm_unpacklo_ps(row0, row1);  //tmp0 will contain the lower part of row0 and row1 interleaved
-            __m128 tmp1 = _mm_unpackhi_ps(row0, row1);  //tmp1 will contain the higher part of row0 and row1 interleaved
-            __m128 tmp2 = _mm_unpacklo_ps(row2, row3);
-            __m128 tmp3 = _mm_unpackhi_ps(row2, row3);
-
-
-            // Rearrange the tmp register by interleaving the inputs lower and higher parts
-            __m128 col0 = _mm_movelh_ps(tmp0, tmp2);  //col0 will contain, in order, the lower part of tmp0 and lower part of tmp2
-            __m128 col1 = _mm_movehl_ps(tmp2, tmp0);  //col1 will contain, in order, the higher part of tmp0 and the higher part of tmp2
-            __m128 col2 = _mm_movelh_ps(tmp1, tmp3);
-            __m128 col3 = _mm_movehl_ps(tmp3, tmp1);
-
-            // Store transposed block in the output matrix
-            _mm_storeu_ps(&transpose[j][i], col0);      // Store col0 in transpose[j][i]
-            _mm_storeu_ps(&transpose[j + 1][i], col1);
-            _mm_storeu_ps(&transpose[j + 2][i], col2);
-            _mm_storeu_ps(&transpose[j + 3][i], col3);
-        }
-    }
-}
-
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
-        }
-        printf("\n");
-    }
-}
-
-int isRowMajor(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        if (&matrix[i][1] != &matrix[i][0] + 1) { //checking whether memory addresses are contiguous
-            return 0;
-        }
-    }
-    return 1;
+    return total_time / total_iterations;
 }
 
-int matrix_actually_transposed(float **matrix, float **transpose, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != transpose[j][i]) {
-                return 0;
+void matTranspose(const Matrix *matrix, Matrix *transpose, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance) {
+    int rows = matrix->rows;
+    int cols = matrix->cols;
+
+    // Outer level: tiles sized for L2
+    for (int i2 = 0; i2 < rows; i2 += l2_tile) {
+        int i2_end = (i2 + l2_tile < rows) ? i2 + l2_tile : rows;
+        for (int j2 = 0; j2 < cols; j2 += l2_tile) {
+            int j2_end = (j2 + l2_tile < cols) ? j2 + l2_tile : cols;
+
+            // Middle level: tiles sized for L1 inside the current L2 tile
+            for (int i1 = i2; i1 < i2_end; i1 += l1_tile) {
+                int i1_end = (i1 + l1_tile < i2_end) ? i1 + l1_tile : i2_end;
+                for (int j1 = j2; j1 < j2_end; j1 += l1_tile) {
+                    int j1_end = (j1 + l1_tile < j2_end) ? j1 + l1_tile : j2_end;
+
+                    // Register level: blocks of the kernel transposed in registers
+                    for (int i = i1; i < i1_end; i += kernel->rows) {
+                        int block_rows = (i1_end - i < kernel->rows) ? i1_end - i : kernel->rows;
+                        for (int j = j1; j < j1_end; j += kernel->cols) {
+                            int block_cols = (j1_end - j < kernel->cols) ? j1_end - j : kernel->cols;
+                            if (block_rows == kernel->rows && block_cols == kernel->cols) {
+                                // past the last columns there is nothing left to prefetch on these rows
+                                int ahead = (j + distance + kernel->cols <= cols) ? distance : 0;
+                                kernel->transpose(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, ahead);
+                            } else {
+                                // remainder rows and columns at the edge of the matrix
+                                transposeBlockPartial4x4(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, block_rows, block_cols);
+                            }
+                        }
+                    }
+                }
             }
         }
     }
-    return 1;
 }
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #ifdef _WIN32
 #include <windows.h>
 #else
@@ -7,22 +8,93 @@
 #endif
 #include <time.h>
 #include <immintrin.h>
+#include "transpose.h"
+#include "simd_kernels.h"
+
+// Side of the register-level block
+#define BLOCK_SIZE 8
+// Default tile sides (in elements) for the two cache levels. On the Xeon Gold 6252N (32KB L1d, 1MB L2)
+// a 32x32 source tile plus its destination take 8KB of L1 and a 256x256 pair takes 512KB of L2.
+#define DEFAULT_L1_TILE 32
+#define DEFAULT_L2_TILE 256
+// Number of iterations averaged for every tile pair in sweep mode
+#define SWEEP_ITERATIONS 10
+// Default prefetch distance (in elements): one L1 tile ahead, i.e. the same block of the next tile
+#define DEFAULT_PREFETCH_DISTANCE DEFAULT_L1_TILE
+// Size (in bytes) of the transpose from which the stores bypass the cache when no calibration is run:
+// about the 35.75MB L3 of the Xeon Gold 6252N, past which T cannot stay in cache anyway
+#define DEFAULT_STREAM_THRESHOLD ((size_t)32 << 20)
+// Store modes of the out-of-place transposition
+#define STORES_CACHED 0
+#define STORES_STREAMING 1
+#define STORES_AUTO 2
+
+// A register kernel of matTranspose: it transposes the full rows x cols blocks of src (rows lds floats apart)
+// into dst (rows ldd floats apart). distance is the prefetch distance of the kernels that prefetch, the
+// others ignore it. The streaming ones write with non-temporal stores, fenced once the transposition is over
+typedef struct {
+    const char *description;
+    int rows, cols;
+    int streaming;
+    void (*transpose)(const float *src, int lds, float *dst, int ldd, int distance);
+} RegisterKernel;
+
+//transposeBlock8x8 with the signature of the register kernels (it prefetches nothing)
+static inline SIMD_TARGET_AVX2 void transposeBlockCached8x8(const float *src, int lds, float *dst, int ldd, int distance) {
+    (void)distance;
+    transposeBlock8x8(src, lds, dst, ldd);
+}
+
+//transposeBlockPairStream8x8 with the signature of the register kernels: the block is two 8x8 blocks on top
+//of each other, so that each line of the transpose is written whole
+static inline SIMD_TARGET_AVX2 void transposeBlockStream16x8(const float *src, int lds, float *dst, int ldd, int distance) {
+    (void)distance;
+    transposeBlockPairStream8x8(src, lds, dst, ldd);
+}
+
+//transposeBlockSplit8x8 with the signature of the register kernels
+static inline SIMD_TARGET_AVX2 void transposeBlockCachedSplit8x8(const float *src, int lds, float *dst, int ldd, int distance) {
+    (void)distance;
+    transposeBlockSplit8x8(src, lds, dst, ldd);
+}
+
+//transposeBlockMacro16x16 with the signature of the register kernels
+static inline SIMD_TARGET_AVX2 void transposeBlockCachedMacro16x16(const float *src, int lds, float *dst, int ldd, int distance) {
+    (void)distance;
+    transposeBlockMacro16x16(src, lds, dst, ldd);
+}
+
+// The plain kernel, the one with non-temporal stores and the one prefetching the block distance columns ahead
+static const RegisterKernel cached_kernel = {"8x8, shuffle_ps and permute2f128", BLOCK_SIZE, BLOCK_SIZE, 0, transposeBlockCached8x8};
+static const RegisterKernel streaming_kernel = {"16x8, non-temporal stores", 2 * BLOCK_SIZE, BLOCK_SIZE, 1, transposeBlockStream16x8};
+static const RegisterKernel prefetch_kernel = {"8x8, prefetching ahead", BLOCK_SIZE, BLOCK_SIZE, 0, transposeBlockPrefetch8x8};
+
+// The kernels of the -kernels comparison, all with cached stores: the first one is the reference of the speedups
+static const RegisterKernel register_kernels[] = {
+    {"8x8, 128-bit halves extracted and joined", BLOCK_SIZE, BLOCK_SIZE, 0, transposeBlockCachedSplit8x8},
+    {"8x8, shuffle_ps and permute2f128", BLOCK_SIZE, BLOCK_SIZE, 0, transposeBlockCached8x8},
+    {"16x16 macro-kernel of four 8x8 blocks", 2 * BLOCK_SIZE, 2 * BLOCK_SIZE, 0, transposeBlockCachedMacro16x16},
+};
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 // %%%%% FUNCTIONS DECLARATION %%%%%% //
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
 
-//initializes the matrix with random values
-void initializeMatrix(float **matrix, int n);
-//transposes the matrix
-void matTranspose(float **matrix, float **transpose, int n);
-//prints the matrix
-void printMatrix(float **matrix, int n);
-//checks if the matrix is stored in row-major order
-int isRowMajor(float **matrix, int n);
-//checks if the matrix is actually transposed
-int matrix_actually_transposed(float **matrix, float **transpose, int n);
+//transposes the matrix visiting L2 tiles, then L1 tiles inside them, then the blocks of the register kernel
+//(distance is passed on to it)
+void matTranspose(const Matrix *matrix, Matrix *transpose, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance);
+//returns the average time (in seconds) of the transposition with the given tile sizes and register kernel
+double averageTransposeTime(Matrix *M, Matrix *T, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance, int total_iterations);
+//returns the streaming kernel if streaming is asked and the lines of the transpose can be written whole (its
+//leading dimension and the L1 tile multiples of 16 floats), the cached one otherwise
+const RegisterKernel *storeKernel(const Matrix *transpose, int l1_tile, int streaming);
+//times cached and streaming stores on growing square matrices and returns the size (in bytes) from which streaming wins
+size_t calibrateStreamThreshold(int l2_tile, int l1_tile);
+//transposes a square matrix in place swapping pairs of tiles across the diagonal
+void matTransposeInPlace(Matrix *matrix, int l1_tile);
+//returns the average time (in seconds) of the in-place transposition
+double averageInPlaceTime(Matrix *M, int l1_tile, int total_iterations);
 
 
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
@@ -31,42 +103,196 @@ int matrix_actually_transposed(float **matrix, float **transpose, int n);
 
 int main(int argc, char *argv[]) {
     //Checking the number of arguments
-    if (argc != 2) {
-        printf("Please add a matrix size as an argument.\n");
+    if (argc < 2) {
+        printf("Please add a matrix size as an argument (options: -l2 <tile> -l1 <tile>, -stream on|off|auto, -calibrate, -inplace, -pad auto|<floats>, -huge, -prefetch auto|<distance>, -kernels or -sweep).\n");
         return 1;
     }
 
-    //Checking the matrix size
-    int exponent = atoi(argv[1]);
-    if (exponent < 4 || exponent > 12) {
-        printf("Matrix size exponent must be between 4 and 12 (recall that the base is 2).\n");
+    //Checking the matrix size (exponent of a square matrix or explicit rows x cols)
+    int rows, cols;
+    if (!parseMatrixSize(argv[1], &rows, &cols)) {
+        printf("Matrix size must be an exponent between 4 and 12 (recall that the base is 2) or an explicit size such as 1000x700.\n");
         return 1;
     }
 
-    //Calculating the matrix size by shifting by the exponent
-    int matrix_size = 1 << exponent;
+    //Reading the tile sizes (or the sweep request) from the options
+    int l2_tile = DEFAULT_L2_TILE;
+    int l1_tile = DEFAULT_L1_TILE;
+    int sweep = 0;
+    int padding = 0;
+    int huge_pages = 0;
+    int prefetch_distance = 0;
+    int in_place = 0;
+    int stores = STORES_AUTO;
+    int calibrate = 0;
+    int kernels = 0;
+    for (int a = 2; a < argc; a++) {
+        if (strcmp(argv[a], "-l2") == 0 && a + 1 < argc) {
+            l2_tile = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-l1") == 0 && a + 1 < argc) {
+            l1_tile = atoi(argv[++a]);
+        } else if (strcmp(argv[a], "-stream") == 0 && a + 1 < argc) {
+            a++;
+            if (strcmp(argv[a], "on") == 0) {
+                stores = STORES_STREAMING;
+            } else if (strcmp(argv[a], "off") == 0) {
+                stores = STORES_CACHED;
+            } else if (strcmp(argv[a], "auto") == 0) {
+                stores = STORES_AUTO;
+            } else {
+                printf("The store mode must be on, off or auto.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-calibrate") == 0) {
+            calibrate = 1;
+        } else if (strcmp(argv[a], "-inplace") == 0) {
+            in_place = 1;
+        } else if (strcmp(argv[a], "-pad") == 0 && a + 1 < argc) {
+            padding = parsePadding(argv[++a]);
+            if (padding < 0) {
+                printf("The padding must be auto or a number of floats between 0 and 4096.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-prefetch") == 0 && a + 1 < argc) {
+            a++;
+            prefetch_distance = (strcmp(argv[a], "auto") == 0) ? DEFAULT_PREFETCH_DISTANCE : atoi(argv[a]);
+            if (prefetch_distance <= 0) {
+                printf("The prefetch distance must be auto or a positive number of elements.\n");
+                return 1;
+            }
+        } else if (strcmp(argv[a], "-huge") == 0) {
+            huge_pages = 1;
+        } else if (strcmp(argv[a], "-kernels") == 0) {
+            kernels = 1;
+        } else if (strcmp(argv[a], "-sweep") == 0) {
+            sweep = 1;
+        } else {
+            printf("Unknown option %s.\n", argv[a]);
+            return 1;
+        }
+    }
+    if (l1_tile <= 0 || l2_tile <= 0 || l1_tile % BLOCK_SIZE != 0 || l2_tile % l1_tile != 0) {
+        printf("Tile sizes must be multiples of %d and the L2 tile must be a multiple of the L1 tile.\n", BLOCK_SIZE);
+        return 1;
+    }
 
-    //Allocating memory for the matrices M and T
-    float **M = (float **)malloc(matrix_size * sizeof(float *));
-    float **T = (float **)malloc(matrix_size * sizeof(float *));
-    for (int i = 0; i < matrix_size; i++) {
-        M[i] = (float *)malloc(matrix_size * sizeof(float));
-        T[i] = (float *)malloc(matrix_size * sizeof(float));
+    //Choosing the store mode: in auto mode the stores stream once the transpose is larger than the threshold
+    size_t stream_threshold = DEFAULT_STREAM_THRESHOLD;
+    if (calibrate) {
+        stream_threshold = calibrateStreamThreshold(l2_tile, l1_tile);
+    }
+    int streaming = (stores == STORES_AUTO) ? (size_t)rows * cols * sizeof(float) >= stream_threshold : stores;
+    //Whole lines of T can only be streamed if its rows (M's number of rows) and the L1 tiles are multiples of 16 floats
+    streaming = streaming && l1_tile % (2 * BLOCK_SIZE) == 0 && rows % (2 * BLOCK_SIZE) == 0;
+
+    //Allocating memory for the matrices M and T (one contiguous aligned block each)
+    Matrix M, T;
+    if (!allocMatrix(&M, rows, cols) || !allocMatrix(&T, cols, rows)) {
+        printf("Unable to allocate the matrices.\n");
+        return 1;
     }
 
-    //Set the number of iterations to get a better average time
-    int total_iterations = 50;
+    if (sweep) {
+        //Trying every pair of power of two tiles that fits in the matrix and keeping the fastest one
+        int best_l2 = 0, best_l1 = 0;
+        double best_time = 0.0;
+        for (int l2 = BLOCK_SIZE; l2 < 2 * rows || l2 < 2 * cols; l2 *= 2) {
+            for (int l1 = BLOCK_SIZE; l1 <= l2; l1 *= 2) {
+                double avg_time = averageTransposeTime(&M, &T, l2, l1, storeKernel(&T, l1, streaming), 0, SWEEP_ITERATIONS);
+                printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Average time taken: %.3fms\n", rows, cols, l2, l1, avg_time / 1e-3);
+                if (best_l2 == 0 || avg_time < best_time) {
+                    best_l2 = l2;
+                    best_l1 = l1;
+                    best_time = avg_time;
+                }
+            }
+        }
+        printf("Best tiles for %d x %d: L2 tile %d, L1 tile %d. Average time taken: %.3fms\n", rows, cols, best_l2, best_l1, best_time / 1e-3);
+    } else {
+        //Set the number of iterations to get a better average time
+        int total_iterations = 50;
+        double avg_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, storeKernel(&T, l1_tile, streaming), 0, total_iterations);
+        printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Stores: %s. Average time taken: %.3fms\n", rows, cols, l2_tile, l1_tile, streaming ? "streaming" : "cached", avg_time / 1e-3);
+
+        //Running the same transposition with padded rows right after, so the two layouts can be compared side by side
+        double reference_time = avg_time;
+        if (padding > 0) {
+            Matrix PM, PT;
+            if (!allocMatrixPadded(&PM, rows, cols, cols + padding) || !allocMatrixPadded(&PT, cols, rows, rows + padding)) {
+                printf("Unable to allocate the padded matrices.\n");
+                return 1;
+            }
+            double padded_time = averageTransposeTime(&PM, &PT, l2_tile, l1_tile, storeKernel(&PT, l1_tile, streaming), 0, total_iterations);
+            printf("Matrix size: %d x %d. Padded leading dimensions: %d and %d. L2 tile: %d. L1 tile: %d. Stores: %s. Average time taken: %.3fms\n", rows, cols, PM.ld, PT.ld, l2_tile, l1_tile, storeKernel(&PT, l1_tile, streaming)->streaming ? "streaming" : "cached", padded_time / 1e-3);
+            freeMatrix(&PM);
+            freeMatrix(&PT);
+            reference_time = padded_time;
+        }
+
+        //Running the same transposition (same padding) on buffers backed by 2MB pages: a 4096 x 4096 matrix
+        //spans 16384 4KB pages but only 32 huge ones, so the column walk of T stops missing in the TLB
+        if (huge_pages) {
+            Matrix HM, HT;
+            if (!allocMatrixHugePages(&HM, rows, cols, cols + padding) || !allocMatrixHugePages(&HT, cols, rows, rows + padding)) {
+                printf("Unable to allocate the huge page matrices.\n");
+                return 1;
+            }
+            double huge_time = averageTransposeTime(&HM, &HT, l2_tile, l1_tile, storeKernel(&HT, l1_tile, streaming), 0, total_iterations);
+            printf("Matrix size: %d x %d. Pages: %s and %s. L2 tile: %d. L1 tile: %d. Stores: %s. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, matrixPagesName(&HM), matrixPagesName(&HT), l2_tile, l1_tile, storeKernel(&HT, l1_tile, streaming)->streaming ? "streaming" : "cached", huge_time / 1e-3, reference_time / huge_time);
+            freeMatrix(&HM);
+            freeMatrix(&HT);
+        }
+
+        //Running the prefetching kernel right after, so that the two kernels can be compared side by side
+        if (prefetch_distance > 0) {
+            double prefetch_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, &prefetch_kernel, prefetch_distance, total_iterations);
+            printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Stores: cached. Prefetch distance: %d. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, l2_tile, l1_tile, prefetch_distance, prefetch_time / 1e-3, avg_time / prefetch_time);
+        }
+
+        //Timing every register kernel with the same tiles, so that they can be compared side by side
+        if (kernels) {
+            double split_time = 0.0;
+            for (int k = 0; k < (int)(sizeof(register_kernels) / sizeof(register_kernels[0])); k++) {
+                const RegisterKernel *kernel = &register_kernels[k];
+                if (l1_tile % kernel->rows != 0 || l1_tile % kernel->cols != 0) {
+                    printf("Matrix size: %d x %d. Register kernel: %s. The L1 tile must be a multiple of %d.\n", rows, cols, kernel->description, kernel->rows);
+                    continue;
+                }
+                double kernel_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, kernel, 0, total_iterations);
+                if (k == 0) {
+                    split_time = kernel_time;
+                }
+                printf("Matrix size: %d x %d. L2 tile: %d. L1 tile: %d. Register kernel: %s. Average time taken: %.3fms. Speedup: %.2fx\n", rows, cols, l2_tile, l1_tile, kernel->description, kernel_time / 1e-3, split_time / kernel_time);
+            }
+        }
+
+        //Running the in-place version right after, so the two paths can be compared side by side
+        if (in_place && rows != cols) {
+            printf("The in-place transposition needs a square matrix (see transposition_inplace_cycles.c for rectangular ones).\n");
+        } else if (in_place) {
+            double in_place_time = averageInPlaceTime(&M, l1_tile, total_iterations);
+            printf("Matrix size: %d x %d. In-place, L1 tile: %d. Average time taken: %.3fms\n", rows, cols, l1_tile, in_place_time / 1e-3);
+        }
+    }
+    
+    //Freeing memory
+    freeMatrix(&M);
+    freeMatrix(&T);
+    
+    return 0;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%% FUNCTIONS DEFINITION %%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+double averageTransposeTime(Matrix *M, Matrix *T, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance, int total_iterations) {
     double total_time = 0.0;
 
     for(int i = 0; i < total_iterations; i++) {
         // Initializing the completely casual matrix
-        initializeMatrix(M, matrix_size);
-
-        // Check if the matrix is stored in row-major order
-        if (!isRowMajor(M, matrix_size)) {
-            printf("Matrix is not stored in row-major order.\n");
-            return 1;
-        }
+        initializeMatrix(M);
 
         // Structure to store the time
         struct timeval start, end;
@@ -79,7 +305,7 @@ int main(int argc, char *argv[]) {
         #else
             gettimeofday(&start, NULL);
         #endif
-        matTranspose(M, T, matrix_size);
+        matTranspose(M, T, l2_tile, l1_tile, kernel, distance);
         #ifdef _WIN32
             mingw_gettimeofday(&end, NULL);
         #else
@@ -93,154 +319,173 @@ int main(int argc, char *argv[]) {
 
         //CHECK SECTION - Uncomment to check the matrices
         // Check whether the matrix is actually transposed
-        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T, matrix_size) ? "YES" : "NO");
+        // printf("Matrix's actually transposed: %s\n", matrix_actually_transposed(M, T) ? "YES" : "NO");
 
         // printf("Original Matrix:\n");
-        // printMatrix(M, matrix_size);
+        // printMatrix(M);
 
         // printf("Transposed Matrix:\n");
-        // printMatrix(T, matrix_size);
-    }
-
-    double avg_time = total_time / total_iterations;
-    printf("Matrix size: %d x %d. Average time taken: %.3fms\n", matrix_size, matrix_size, avg_time / 1e-3);
-    
-    //Freeing memory
-    for (int i = 0; i < matrix_size; i++) {
-        free(M[i]);
-        free(T[i]);
+        // printMatrix(T);
     }
 
-    free(M);
-    free(T);
-    
-    return 0;
+    return total_time / total_iterations;
 }
 
+size_t calibrateStreamThreshold(int l2_tile, int l1_tile) {
+    // Smallest size from which streaming stays faster for every larger size tried (none means never)
+    size_t threshold = 0;
 
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
-// %%%%%% FUNCTIONS DEFINITION %%%%%% //
-// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+    for (int n = 256; n <= 4096; n *= 2) {
+        Matrix M, T;
+        if (!allocMatrix(&M, n, n) || !allocMatrix(&T, n, n)) {
+            printf("Unable to allocate the matrices for the calibration.\n");
+            exit(1);
+        }
+
+        double cached_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, storeKernel(&T, l1_tile, 0), 0, SWEEP_ITERATIONS);
+        double streaming_time = averageTransposeTime(&M, &T, l2_tile, l1_tile, storeKernel(&T, l1_tile, 1), 0, SWEEP_ITERATIONS);
+        printf("Calibration %d x %d. Cached stores: %.3fms. Streaming stores: %.3fms\n", n, n, cached_time / 1e-3, streaming_time / 1e-3);
 
-void initializeMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            matrix[i][j] = (float)rand();
+        if (streaming_time < cached_time) {
+            if (threshold == 0) {
+                threshold = (size_t)n * n * sizeof(float);
+            }
+        } else {
+            threshold = 0;
         }
+
+        freeMatrix(&M);
+        freeMatrix(&T);
+    }
+
+    if (threshold == 0) {
+        threshold = (size_t)-1;
+        printf("Streaming threshold: never faster up to 4096 x 4096, streaming stays off.\n");
+    } else {
+        printf("Streaming threshold: %zu bytes.\n", threshold);
     }
+    return threshold;
 }
 
-void matTranspose(float** matrix, float** transpose, int n) {
-    const int blockSize = 8;
-    for (int i = 0; i < n; i += blockSize) {
-        for (int j = 0; j < n; j += blockSize) {
-
-            // %%%%%%%%%%%% to compile with flag -mavx2 %%%%%%%%%%%%
-
-            // loads 4 floats at time into row0, row1, row2, row3 --m256 registers
-            __m256 row0 = _mm256_loadu_ps(&matrix[i][j]);  //row0 = (matrix[i][j], matrix[i][j+1], matrix[i][j+2], matrix[i][j+3], matrix[i][j+4], matrix[i][j+5], matrix[i][j+6], matrix[i][j+7])
-            __m256 row1 = _mm256_loadu_ps(&matrix[i + 1][j]);
-            __m256 row2 = _mm256_loadu_ps(&matrix[i + 2][j]);
-            __m256 row3 = _mm256_loadu_ps(&matrix[i + 3][j]);
-            __m256 row4 = _mm256_loadu_ps(&matrix[i + 4][j]);
-            __m256 row5 = _mm256_loadu_ps(&matrix[i + 5][j]);
-            __m256 row6 = _mm256_loadu_ps(&matrix[i + 6][j]);
-            __m256 row7 = _mm256_loadu_ps(&matrix[i + 7][j]);
-
-            // Rearrange the rows, by interleaving the inputs lower and higher parts
-            __m256 tmp0 = _mm256_unpacklo_ps(row0, row1);  //tmp0 will contain the lower part of row0 and row1 interleaved
-            __m256 tmp1 = _mm256_unpackhi_ps(row0, row1);  //tmp1 will contain the higher part of row0 and row1 interleaved
-            __m256 tmp2 = _mm256_unpacklo_ps(row2, row3);
-            __m256 tmp3 = _mm256_unpackhi_ps(row2, row3);
-            __m256 tmp4 = _mm256_unpacklo_ps(row4, row5);
-            __m256 tmp5 = _mm256_unpackhi_ps(row4, row5);
-            __m256 tmp6 = _mm256_unpacklo_ps(row6, row7);
-            __m256 tmp7 = _mm256_unpackhi_ps(row6, row7);
-
-            //Subdivide each row in rows of 4 floats
-            __m128 low_tmp0 = _mm256_castps256_ps128(tmp0);        // [0, 8, 1, 9]
-            __m128 high_tmp0 = _mm256_extractf128_ps(tmp0, 1);     // [4, 12, 5, 13]
-            __m128 low_tmp1 = _mm256_castps256_ps128(tmp1);        // [2, 10, 3, 11]
-            __m128 high_tmp1 = _mm256_extractf128_ps(tmp1, 1);     // [6, 14, 7, 15]
-            __m128 low_tmp2 = _mm256_castps256_ps128(tmp2);        // [16, 24, 17, 25]
-            __m128 high_tmp2 = _mm256_extractf128_ps(tmp2, 1);     // [20, 28, 21, 29]
-            __m128 low_tmp3 = _mm256_castps256_ps128(tmp3);        // [18, 26, 19, 27]
-            __m128 high_tmp3 = _mm256_extractf128_ps(tmp3, 1);     // [22, 30, 23, 31]
-            __m128 low_tmp4 = _mm256_castps256_ps128(tmp4);        // [32, 40, 33, 41]
-            __m128 high_tmp4 = _mm256_extractf128_ps(tmp4, 1);     // [36, 44, 37, 45]
-            __m128 low_tmp5 = _mm256_castps256_ps128(tmp5);        // [34, 42, 35, 43]
-            __m128 high_tmp5 = _mm256_extractf128_ps(tmp5, 1);     // [38, 46, 39, 47]
-            __m128 low_tmp6 = _mm256_castps256_ps128(tmp6);        // [48, 56, 49, 57]
-            __m128 high_tmp6 = _mm256_extractf128_ps(tmp6, 1);     // [52, 60, 53, 61]
-            __m128 low_tmp7 = _mm256_castps256_ps128(tmp7);        // [50, 58, 51, 59]
-            __m128 high_tmp7 = _mm256_extractf128_ps(tmp7, 1);     // [54, 62, 55, 63]
-
-            // Rearrange the tmp register by interleaving the inputs lower and higher parts
-            __m128 col0low = _mm_movelh_ps(low_tmp0, low_tmp2);
-            __m128 col0high = _mm_movelh_ps(low_tmp4, low_tmp6);
-            __m128 col1low = _mm_movehl_ps(low_tmp2, low_tmp0);
-            __m128 col1high = _mm_movehl_ps(low_tmp6, low_tmp4);
-            __m128 col2low = _mm_movelh_ps(low_tmp1, low_tmp3);
-            __m128 col2high = _mm_movelh_ps(low_tmp5, low_tmp7);
-            __m128 col3low = _mm_movehl_ps(low_tmp3, low_tmp1);
-            __m128 col3high = _mm_movehl_ps(low_tmp7, low_tmp5);
-            __m128 col4low = _mm_movelh_ps(high_tmp0, high_tmp2);
-            __m128 col4high = _mm_movelh_ps(high_tmp4, high_tmp6);
-            __m128 col5low = _mm_movehl_ps(high_tmp2, high_tmp0);
-            __m128 col5high = _mm_movehl_ps(high_tmp6, high_tmp4);
-            __m128 col6low = _mm_movelh_ps(high_tmp1, high_tmp3);
-            __m128 col6high = _mm_movelh_ps(high_tmp5, high_tmp7);
-            __m128 col7low = _mm_movehl_ps(high_tmp3, high_tmp1);
-            __m128 col7high = _mm_movehl_ps(high_tmp7, high_tmp5);
-            
-            // Merge together again the lower and higher parts of the columns
-            __m256 col0 = _mm256_set_m128(col0high, col0low);
-            __m256 col1 = _mm256_set_m128(col1high, col1low);   
-            __m256 col2 = _mm256_set_m128(col2high, col2low);
-            __m256 col3 = _mm256_set_m128(col3high, col3low);   
-            __m256 col4 = _mm256_set_m128(col4high, col4low);
-            __m256 col5 = _mm256_set_m128(col5high, col5low);
-            __m256 col6 = _mm256_set_m128(col6high, col6low);
-            __m256 col7 = _mm256_set_m128(col7high, col7low);
-
-            // Store transposed block in the output matrix
-            _mm256_storeu_ps(&transpose[j][i], col0);      // Store col0 in transpose[j][i]
-            _mm256_storeu_ps(&transpose[j + 1][i], col1);
-            _mm256_storeu_ps(&transpose[j + 2][i], col2);
-            _mm256_storeu_ps(&transpose[j + 3][i], col3);
-            _mm256_storeu_ps(&transpose[j + 4][i], col4);
-            _mm256_storeu_ps(&transpose[j + 5][i], col5);
-            _mm256_storeu_ps(&transpose[j + 6][i], col6);
-            _mm256_storeu_ps(&transpose[j + 7][i], col7);
-        }
+const RegisterKernel *storeKernel(const Matrix *transpose, int l1_tile, int streaming) {
+    // Non-temporal stores write whole 64-byte lines (16 floats, two blocks on top of each other): the buffer
+    // is aligned, so every line is as long as the L1 tiles and the leading dimension are multiples of 16 floats
+    if (streaming && l1_tile % (2 * BLOCK_SIZE) == 0 && transpose->ld % (2 * BLOCK_SIZE) == 0) {
+        return &streaming_kernel;
     }
+    return &cached_kernel;
 }
 
-void printMatrix(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            printf("%6.2f ", matrix[i][j]);
+void matTranspose(const Matrix *matrix, Matrix *transpose, int l2_tile, int l1_tile, const RegisterKernel *kernel, int distance) {
+    const int blockSize = BLOCK_SIZE;
+    int rows = matrix->rows;
+    int cols = matrix->cols;
+
+    // Outer level: tiles sized for L2
+    for (int i2 = 0; i2 < rows; i2 += l2_tile) {
+        int i2_end = (i2 + l2_tile < rows) ? i2 + l2_tile : rows;
+        for (int j2 = 0; j2 < cols; j2 += l2_tile) {
+            int j2_end = (j2 + l2_tile < cols) ? j2 + l2_tile : cols;
+
+            // Middle level: tiles sized for L1 inside the current L2 tile
+            for (int i1 = i2; i1 < i2_end; i1 += l1_tile) {
+                int i1_end = (i1 + l1_tile < i2_end) ? i1 + l1_tile : i2_end;
+                for (int j1 = j2; j1 < j2_end; j1 += l1_tile) {
+                    int j1_end = (j1 + l1_tile < j2_end) ? j1 + l1_tile : j2_end;
+
+                    // Register level: blocks of the kernel transposed in registers
+                    for (int i = i1; i < i1_end; i += kernel->rows) {
+                        for (int j = j1; j < j1_end; j += kernel->cols) {
+                            if (i + kernel->rows <= i1_end && j + kernel->cols <= j1_end) {
+                                // past the last columns there is nothing left to prefetch on these rows
+                                int ahead = (j + distance + kernel->cols <= cols) ? distance : 0;
+                                kernel->transpose(&MAT(matrix, i, j), matrix->ld, &MAT(transpose, j, i), transpose->ld, ahead);
+                                continue;
+                            }
+                            // remainder rows and columns at the edge of the tile, in 8x8 blocks with cached stores
+                            for (int bi = i; bi < i + kernel->rows && bi < i1_end; bi += blockSize) {
+                                int block_rows = (i1_end - bi < blockSize) ? i1_end - bi : blockSize;
+                                for (int bj = j; bj < j + kernel->cols && bj < j1_end; bj += blockSize) {
+                                    int block_cols = (j1_end - bj < blockSize) ? j1_end - bj : blockSize;
+                                    if (block_rows == blockSize && block_cols == blockSize) {
+                                        transposeBlock8x8(&MAT(matrix, bi, bj), matrix->ld, &MAT(transpose, bj, bi), transpose->ld);
+                                    } else {
+                                        transposeBlockPartial8x8(&MAT(matrix, bi, bj), matrix->ld, &MAT(transpose, bj, bi), transpose->ld, block_rows, block_cols);
+                                    }
+                                }
+                            }
+                        }
+                    }
+                }
+            }
         }
-        printf("\n");
+    }
+
+    // The non-temporal stores are weakly ordered: make them visible before anyone reads the transpose
+    if (kernel->streaming) {
+        _mm_sfence();
     }
 }
 
-int isRowMajor(float **matrix, int n) {
-    for (int i = 0; i < n; i++) {
-        if (&matrix[i][1] != &matrix[i][0] + 1) { //checking whether memory addresses are contiguous
-            return 0;
-        }
+double averageInPlaceTime(Matrix *M, int l1_tile, int total_iterations) {
+    double total_time = 0.0;
+
+    for(int i = 0; i < total_iterations; i++) {
+        // Initializing the completely casual matrix
+        initializeMatrix(M);
+
+        // Structure to store the time
+        struct timeval start, end;
+        long seconds, microseconds;
+        double time_taken;
+
+        // Transposing the matrix over itself
+        #ifdef _WIN32
+            mingw_gettimeofday(&start, NULL);
+        #else
+            gettimeofday(&start, NULL);
+        #endif
+        matTransposeInPlace(M, l1_tile);
+        #ifdef _WIN32
+            mingw_gettimeofday(&end, NULL);
+        #else
+            gettimeofday(&end, NULL);
+        #endif
+
+        seconds = end.tv_sec - start.tv_sec;
+        microseconds = end.tv_usec - start.tv_usec;
+        time_taken = seconds + microseconds * 1e-6;
+        total_time += time_taken;
     }
-    return 1;
+
+    return total_time / total_iterations;
 }
 
-int matrix_actually_transposed(float **matrix, float **transpose, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            if (matrix[i][j] != transpose[j][i]) {
-                return 0;
+void matTransposeInPlace(Matrix *matrix, int l1_tile) {
+    const int blockSize = BLOCK_SIZE;
+    int n = matrix->rows;
+
+    // Only the tiles on and above the diagonal are visited: each one is swapped with its mirror
+    for (int i1 = 0; i1 < n; i1 += l1_tile) {
+        int i1_end = (i1 + l1_tile < n) ? i1 + l1_tile : n;
+        for (int j1 = i1; j1 < n; j1 += l1_tile) {
+            int j1_end = (j1 + l1_tile < n) ? j1 + l1_tile : n;
+
+            for (int i = i1; i < i1_end; i += blockSize) {
+                int block_rows = (i1_end - i < blockSize) ? i1_end - i : blockSize;
+                // inside a diagonal tile start from the diagonal block, so that no pair is swapped twice
+                for (int j = (i1 == j1) ? i : j1; j < j1_end; j += blockSize) {
+                    int block_cols = (j1_end - j < blockSize) ? j1_end - j : blockSize;
+                    if (block_rows != blockSize || block_cols != blockSize) {
+                        // remainder rows and columns at the edge of the matrix (diagonal ones included)
+                        swapTransposeBlocksPartial8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld, block_rows, block_cols);
+                    } else if (i == j) {
+                        transposeBlockInPlace8x8(&MAT(matrix, i, i), matrix->ld);
+                    } else {
+                        swapTransposeBlocks8x8(&MAT(matrix, i, j), &MAT(matrix, j, i), matrix->ld);
+                    }
+                }
             }
         }
     }
-    return 1;
 }
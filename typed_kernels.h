@@ -0,0 +1,180 @@
+#ifndef TYPED_KERNELS_H
+#define TYPED_KERNELS_H
+
+#include <stdint.h>
+#include <immintrin.h>
+#include "simd_kernels.h"
+
+// Side (in elements) of the tiles visited by the typed transpositions: a multiple of every block side below
+#define TYPED_TILE_SIZE 32
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%% UNPACK NETWORKS %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// A block of side n is transposed in n registers with log2(n) stages of unpacks. Each stage interleaves
+// the rows two by two, every time with elements twice as wide as in the stage before: bytes, then 16, 32,
+// 64 bits, and on 256-bit registers finally the two 128-bit lanes. The lower halves of rows 2m and 2m+1 go
+// to row m and the upper halves to row m + n/2, so the same loop serves every width: only the list of
+// stages changes, and a narrower element just adds one stage in front of the list of the wider one
+#define TRANSPOSE_STAGE(row, tmp, n, UNPACK_LO, UNPACK_HI) \
+    for (int m = 0; m < (n) / 2; m++) { \
+        tmp[m] = UNPACK_LO(row[2 * m], row[2 * m + 1]); \
+        tmp[m + (n) / 2] = UNPACK_HI(row[2 * m], row[2 * m + 1]); \
+    } \
+    for (int m = 0; m < (n); m++) { \
+        row[m] = tmp[m]; \
+    }
+
+// the last stage of the 256-bit networks: the 128-bit lanes of two rows
+#define UNPACK_LO_LANES(a, b) _mm256_permute2x128_si256(a, b, 0x20)
+#define UNPACK_HI_LANES(a, b) _mm256_permute2x128_si256(a, b, 0x31)
+
+// 128-bit registers (SSE2)
+#define NETWORK_SSE_64(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm_unpacklo_epi64, _mm_unpackhi_epi64)
+#define NETWORK_SSE_32(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm_unpacklo_epi32, _mm_unpackhi_epi32) NETWORK_SSE_64(row, tmp, n)
+#define NETWORK_SSE_16(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm_unpacklo_epi16, _mm_unpackhi_epi16) NETWORK_SSE_32(row, tmp, n)
+#define NETWORK_SSE_8(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm_unpacklo_epi8, _mm_unpackhi_epi8) NETWORK_SSE_16(row, tmp, n)
+
+// 256-bit registers (AVX2): the unpacks work inside each 128-bit lane, the lanes are exchanged last
+#define NETWORK_AVX2_128(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, UNPACK_LO_LANES, UNPACK_HI_LANES)
+#define NETWORK_AVX2_64(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm256_unpacklo_epi64, _mm256_unpackhi_epi64) NETWORK_AVX2_128(row, tmp, n)
+#define NETWORK_AVX2_32(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm256_unpacklo_epi32, _mm256_unpackhi_epi32) NETWORK_AVX2_64(row, tmp, n)
+#define NETWORK_AVX2_16(row, tmp, n) \
+    TRANSPOSE_STAGE(row, tmp, n, _mm256_unpacklo_epi16, _mm256_unpackhi_epi16) NETWORK_AVX2_32(row, tmp, n)
+
+//returns the column of the block held by register k at the end of a network: the stages leave the
+//columns in bit-reversed order inside each group of lane registers (lane = elements per 128 bits)
+static inline int transposeRowOrder(int k, int lane) {
+    int reversed = 0;
+    for (int bit = 1; bit < lane; bit <<= 1) {
+        reversed = (reversed << 1) | ((k & bit) != 0);
+    }
+    return (k & ~(lane - 1)) + reversed;
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%% KERNEL GENERATOR %%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// Defines, for the element type TYPE (function names ending with NAME), the in-register kernel of a
+// SIDE x SIDE block and the whole-matrix functions built on it:
+//   transposeBlock<NAME>   transposes one block (rows lds and ldd elements apart)
+//   blockIsMirror<NAME>    checks that a block is the transpose of another one
+//   matTranspose<NAME>     transposes a rows x cols matrix (edge blocks element by element)
+//   checkSym<NAME>         checks if a matrix is symmetric comparing each block below the diagonal with its mirror
+// VEC, LOAD and STORE are the register type and its unaligned accesses, NETWORK the list of unpack stages,
+// LANE the elements per 128 bits and DIFFER(a, b) is nonzero if any element of a is not equal to the one of b
+#define DEFINE_TYPED_KERNELS(NAME, TYPE, TARGET, VEC, SIDE, LANE, LOAD, STORE, NETWORK, DIFFER) \
+\
+static inline TARGET void transposeBlock##NAME(const TYPE *src, int lds, TYPE *dst, int ldd) { \
+    VEC row[SIDE], tmp[SIDE]; \
+    for (int k = 0; k < SIDE; k++) { \
+        row[k] = LOAD((const VEC *)(src + (size_t)k * lds)); \
+    } \
+    NETWORK(row, tmp, SIDE) \
+    for (int k = 0; k < SIDE; k++) { \
+        STORE((VEC *)(dst + (size_t)transposeRowOrder(k, LANE) * ldd), row[k]); \
+    } \
+} \
+\
+static inline TARGET int blockIsMirror##NAME(const TYPE *block, const TYPE *mirror, int ld) { \
+    VEC row[SIDE], tmp[SIDE]; \
+    for (int k = 0; k < SIDE; k++) { \
+        row[k] = LOAD((const VEC *)(mirror + (size_t)k * ld)); \
+    } \
+    NETWORK(row, tmp, SIDE) \
+    for (int k = 0; k < SIDE; k++) { \
+        VEC original = LOAD((const VEC *)(block + (size_t)transposeRowOrder(k, LANE) * ld)); \
+        if (DIFFER(original, row[k])) { \
+            return 0; \
+        } \
+    } \
+    return 1; \
+} \
+\
+static inline TARGET void matTranspose##NAME(const TYPE *matrix, int lds, TYPE *transpose, int ldd, int rows, int cols) { \
+    for (int i1 = 0; i1 < rows; i1 += TYPED_TILE_SIZE) { \
+        int i1_end = (i1 + TYPED_TILE_SIZE < rows) ? i1 + TYPED_TILE_SIZE : rows; \
+        for (int j1 = 0; j1 < cols; j1 += TYPED_TILE_SIZE) { \
+            int j1_end = (j1 + TYPED_TILE_SIZE < cols) ? j1 + TYPED_TILE_SIZE : cols; \
+            for (int i = i1; i < i1_end; i += SIDE) { \
+                for (int j = j1; j < j1_end; j += SIDE) { \
+                    if (i + SIDE <= i1_end && j + SIDE <= j1_end) { \
+                        transposeBlock##NAME(matrix + (size_t)i * lds + j, lds, transpose + (size_t)j * ldd + i, ldd); \
+                        continue; \
+                    } \
+                    /* remainder rows and columns at the edge of the matrix */ \
+                    for (int ii = i; ii < i + SIDE && ii < i1_end; ii++) { \
+                        for (int jj = j; jj < j + SIDE && jj < j1_end; jj++) { \
+                            transpose[(size_t)jj * ldd + ii] = matrix[(size_t)ii * lds + jj]; \
+                        } \
+                    } \
+                } \
+            } \
+        } \
+    } \
+} \
+\
+static inline TARGET int checkSym##NAME(const TYPE *matrix, int ld, int rows, int cols) { \
+    /* A rectangular matrix can never be symmetric */ \
+    if (rows != cols) { \
+        return 0; \
+    } \
+    int n = rows; \
+    int full = n - n % SIDE; \
+    for (int i = 0; i < full; i += SIDE) { \
+        for (int j = 0; j <= i; j += SIDE) { \
+            if (!blockIsMirror##NAME(matrix + (size_t)i * ld + j, matrix + (size_t)j * ld + i, ld)) { \
+                return 0; \
+            } \
+        } \
+    } \
+    /* remainder rows at the bottom, compared element by element up to the diagonal */ \
+    for (int i = full; i < n; i++) { \
+        for (int j = 0; j < i; j++) { \
+            if (matrix[(size_t)i * ld + j] != matrix[(size_t)j * ld + i]) { \
+                return 0; \
+            } \
+        } \
+    } \
+    return 1; \
+}
+
+
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+// %%%%%%%%% ELEMENT TYPES %%%%%%%%%% //
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% //
+
+// Complex samples, stored as (real, imaginary) pairs of floats: 8 bytes like a double
+typedef float _Complex complex_float;
+
+// Integers are equal when all their bytes are; floating point values are compared as numbers (as in
+// checkSym for floats), so +0 and -0 are equal and NaN is never equal to anything
+#define DIFFER_BYTES_SSE(a, b) (_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)) != 0xFFFF)
+#define DIFFER_BYTES_AVX2(a, b) (_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)) != -1)
+#define DIFFER_FLOAT_AVX2(a, b) (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_NEQ_UQ)) != 0)
+#define DIFFER_DOUBLE_AVX2(a, b) (_mm256_movemask_pd(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_NEQ_UQ)) != 0)
+
+// float: 8x8 blocks of 32-bit elements in 256-bit registers (AVX2)
+DEFINE_TYPED_KERNELS(Float, float, SIMD_TARGET_AVX2, __m256i, 8, 4, _mm256_loadu_si256, _mm256_storeu_si256, NETWORK_AVX2_32, DIFFER_FLOAT_AVX2)
+// double: 4x4 blocks of 64-bit elements in 256-bit registers (AVX2)
+DEFINE_TYPED_KERNELS(Double, double, SIMD_TARGET_AVX2, __m256i, 4, 2, _mm256_loadu_si256, _mm256_storeu_si256, NETWORK_AVX2_64, DIFFER_DOUBLE_AVX2)
+// complex float: the same 64-bit network as double, each element moving as a whole (real and imaginary parts
+// compared as floats)
+DEFINE_TYPED_KERNELS(Complex, complex_float, SIMD_TARGET_AVX2, __m256i, 4, 2, _mm256_loadu_si256, _mm256_storeu_si256, NETWORK_AVX2_64, DIFFER_FLOAT_AVX2)
+// int16: 16x16 blocks of 16-bit elements in 256-bit registers (AVX2)
+DEFINE_TYPED_KERNELS(Int16, int16_t, SIMD_TARGET_AVX2, __m256i, 16, 8, _mm256_loadu_si256, _mm256_storeu_si256, NETWORK_AVX2_16, DIFFER_BYTES_AVX2)
+// int8: 16x16 blocks of bytes in 128-bit registers (SSE2), 32x32 would need twice the 16 ymm registers
+DEFINE_TYPED_KERNELS(Int8, int8_t, SIMD_TARGET_SSE, __m128i, 16, 16, _mm_loadu_si128, _mm_storeu_si128, NETWORK_SSE_8, DIFFER_BYTES_SSE)
+
+#endif